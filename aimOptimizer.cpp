@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: aimOptimizer.cpp
+//
+// Desc: 조준 최적화 (cross-entropy method)
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aimOptimizer.h"
+#include "arena.h"
+#include "rayCaster.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static const double AIM_PI = 3.14159265358979;
+static const int    AIM_RAY_BOUNCES = 4;   // 경로 검사에서 따라갈 쿠션 반사 수
+
+AimConfig DefaultAimConfig()
+{
+    AimConfig cfg;
+    cfg.population = 32;
+    cfg.elites = 6;
+    cfg.iterations = 6;
+    cfg.minPower = 1.0f;
+    cfg.maxPower = 10.0f;
+    cfg.minAngleSigma = 0.002f;
+    cfg.minPowerSigma = 0.05f;
+    cfg.oversample = 4;
+    return cfg;
+}
+
+CAimOptimizer::CAimOptimizer(CThreadPool& pool, const AimConfig& cfg)
+    : m_pool(pool), m_cfg(cfg)
+{
+    if (m_cfg.population < 2) m_cfg.population = 2;
+    if (m_cfg.elites < 1) m_cfg.elites = 1;
+    if (m_cfg.elites > m_cfg.population) m_cfg.elites = m_cfg.population;
+    if (m_cfg.iterations < 1) m_cfg.iterations = 1;
+    if (m_cfg.oversample < 1) m_cfg.oversample = 1;
+}
+
+void CAimOptimizer::evaluate(const SimWorld& world, int shooter, int isWhiteTurn, Sample& s) const
+{
+    const int   reds[2] = { BALL_RED1, BALL_RED2 };
+    const float radiusSum = (float)(2 * SIM_RADIUS);
+
+    SimWorld w = world;
+    simClearHits(w);
+    const SimBall& b = w.ball[shooter];
+    simFire(w, shooter, b.x + s.power * cosf(s.angle), b.z + s.power * sinf(s.angle));
+
+    // 못 맞힌 빨간 공에 가장 가까이 간 거리 (같은 점수끼리 순위를 매기는 용도)
+    float closest[2];
+    for (int r = 0; r < 2; r++) {
+        float dx = b.x - w.ball[reds[r]].x, dz = b.z - w.ball[reds[r]].z;
+        closest[r] = sqrtf(dx * dx + dz * dz) - radiusSum;
+    }
+
+    // simRunHits 와 같이 진행하되 매 step 거리를 같이 잼
+    for (int steps = 1; steps <= SIM_MAX_STEPS && !simAllStopped(w); steps++) {
+        simStep(w, SIM_TIME_STEP);
+        for (int r = 0; r < 2; r++) {
+            float dx = b.x - w.ball[reds[r]].x, dz = b.z - w.ball[reds[r]].z;
+            float gap = sqrtf(dx * dx + dz * dz) - radiusSum;
+            if (gap < closest[r]) closest[r] = gap;
+        }
+        if (steps % 8 == 0 && simHitsSettled(w)) break;
+    }
+
+    s.score = simTurnScore(w, isWhiteTurn);
+    s.fitness = 2.0f * s.score;
+    for (int r = 0; r < 2; r++) {
+        if (!simHit(w, shooter, reds[r])) s.fitness -= std::max(closest[r], 0.0f) * 0.1f;
+    }
+}
+
+AimShot CAimOptimizer::optimize(const SimWorld& world, int isWhiteTurn, std::mt19937& rng, double budgetMs)
+{
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point deadline = Clock::now() + std::chrono::microseconds((long long)(budgetMs * 1000));
+    const int n = m_cfg.population;
+    const int k = m_cfg.elites;
+    const int m = n * m_cfg.oversample;   // 기하 검사로 거르기 전 후보 수
+    int shooter = isWhiteTurn == 1 ? BALL_WHITE : BALL_YELLOW;
+    int opponent = isWhiteTurn == 1 ? BALL_YELLOW : BALL_WHITE;
+
+    // 후보 배열은 스레드마다 둔 arena 에서 (매 호출 reset)
+    static thread_local CArena arena;
+    arena.reset();
+    Sample* samples = arena.alloc<Sample>(m);
+    int* order = arena.alloc<int>(m);
+    int* rest = arena.alloc<int>(m);   // 거른 후보 (std::stable_partition 은 임시 버퍼를 힙에 잡음)
+    float* dirX = arena.alloc<float>(m);
+    float* dirZ = arena.alloc<float>(m);
+    RayHit* rays = arena.alloc<RayHit>(m);
+
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+
+    Sample best;
+    best.angle = 0;
+    best.power = m_cfg.minPower;
+    best.fitness = -1e30f;
+    best.score = -1;
+
+    float meanAngle = 0, sigmaAngle = 0, meanPower = 0, sigmaPower = 0;
+    int iter = 0;
+    int simulations = 0;
+    while (iter < m_cfg.iterations) {
+        // 1 회차: 방향은 고르게 (칸마다 하나), 세기는 전 범위에서. 그 뒤로는 정규분포.
+        for (int i = 0; i < m; i++) {
+            Sample& s = samples[i];
+            if (iter == 0) {
+                s.angle = (float)(2 * AIM_PI * (i + unit(rng)) / m);
+                s.power = m_cfg.minPower + (m_cfg.maxPower - m_cfg.minPower) * unit(rng);
+            }
+            else {
+                s.angle = meanAngle + sigmaAngle * normal(rng);
+                s.power = meanPower + sigmaPower * normal(rng);
+                s.power = std::min(std::max(s.power, m_cfg.minPower), m_cfg.maxPower);
+            }
+        }
+
+        // 시뮬레이션 전에 경로로 거르기: 상대 공에 먼저 닿거나 (파울) 아무 공에도 못 닿는 후보는 뒤로.
+        // 걸러지고 남은 것 중 앞의 population 개만 시뮬레이션 (모자라면 elite 수만큼은 채움).
+        int count = m;
+        for (int i = 0; i < m; i++) order[i] = i;
+        if (m > n) {
+            for (int i = 0; i < m; i++) {
+                dirX[i] = cosf(samples[i].angle);
+                dirZ[i] = sinf(samples[i].angle);
+            }
+            castRays(world, shooter, dirX, dirZ, m, m_cfg.maxPower > 0 ? shotTravelBound(m_cfg.maxPower) : 0,
+                     AIM_RAY_BOUNCES, rays);
+            int kept = 0, dropped = 0;
+            for (int j = 0; j < m; j++) {
+                int i = order[j];
+                if (rays[i].ball >= 0 && rays[i].ball != opponent &&
+                    rays[i].distance <= shotTravelBound(samples[i].power))
+                    order[kept++] = i;
+                else
+                    rest[dropped++] = i;
+            }
+            std::copy(rest, rest + dropped, order + kept);
+            count = std::min(std::max(kept, k), n);
+        }
+
+        // 한 회차 = 한 번의 batch 시뮬레이션
+        TRACE_SCOPE("aim batch");
+        m_pool.parallelFor(count, [&](int i) { evaluate(world, shooter, isWhiteTurn, samples[order[i]]); });
+        simulations += count;
+        iter++;
+
+        std::partial_sort(order, order + k, order + count, [&](int a, int b) {
+            return samples[a].fitness > samples[b].fitness;
+        });
+        if (samples[order[0]].fitness > best.fitness) best = samples[order[0]];
+        if (best.score == 1) break;
+        if (budgetMs > 0 && Clock::now() >= deadline) break;
+
+        // elite 로 분포 다시 잡기. 방향은 가장 좋은 후보 기준으로 [-π, π) 로 펴서 평균.
+        float base = samples[order[0]].angle;
+        float sumA = 0, sumA2 = 0, sumP = 0, sumP2 = 0;
+        for (int e = 0; e < k; e++) {
+            const Sample& s = samples[order[e]];
+            float d = (float)remainder(s.angle - base, 2 * AIM_PI);
+            sumA += d;
+            sumA2 += d * d;
+            sumP += s.power;
+            sumP2 += s.power * s.power;
+        }
+        float mA = sumA / k;
+        meanAngle = base + mA;
+        sigmaAngle = std::max(sqrtf(std::max(sumA2 / k - mA * mA, 0.0f)), m_cfg.minAngleSigma);
+        meanPower = sumP / k;
+        sigmaPower = std::max(sqrtf(std::max(sumP2 / k - meanPower * meanPower, 0.0f)), m_cfg.minPowerSigma);
+    }
+
+    AimShot shot;
+    const SimBall& b = world.ball[shooter];
+    shot.angle = best.angle;
+    shot.power = best.power;
+    shot.targetX = b.x + best.power * cosf(best.angle);
+    shot.targetZ = b.z + best.power * sinf(best.angle);
+    shot.score = best.score;
+    shot.fitness = best.fitness;
+    shot.iterations = iter;
+    shot.simulations = simulations;
+    return shot;
+}
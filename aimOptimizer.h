@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: aimOptimizer.h
+//
+// Desc: 조준 최적화 (cross-entropy method).
+//       샷 = (방향 θ, 세기 p). 조준점은 친 공에서 θ 방향으로 p 만큼 (simFire 는 거리 = 세기).
+//       1 회차는 방향을 고르게 나눈 격자 (거칠게), 그 다음부터는 점수가 좋은 elite 들의
+//       평균/표준편차로 만든 정규분포에서 다시 뽑아 좁혀 감 (세밀하게).
+//       한 회차의 후보들은 먼저 경로 검사로 거르고, 남은 것만 스레드 풀에서
+//       한 번의 parallelFor 로 같이 시뮬레이션함.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __aimOptimizerH__
+#define __aimOptimizerH__
+
+#include "billiardSim.h"
+#include "threadPool.h"
+#include <random>
+
+struct AimConfig {
+    int   population;   // 회차마다 시뮬레이션할 후보 수
+    int   elites;       // 분포를 다시 잡을 때 쓰는 상위 후보 수
+    int   iterations;   // 최대 회차
+    float minPower, maxPower;
+    float minAngleSigma, minPowerSigma;   // 분포가 이보다 좁아지지 않게
+    int   oversample;   // 회차마다 population x oversample 개를 뽑아 경로 검사 (rayCaster) 로 거른 뒤 시뮬레이션
+};
+
+AimConfig DefaultAimConfig();
+
+struct AimShot {
+    float targetX, targetZ;   // 파란공 조준점
+    float angle, power;
+    int   score;              // simTurnScore (+1 이면 빨간 공 둘)
+    float fitness;
+    int   iterations;         // 실제로 돈 회차
+    int   simulations;
+};
+
+class CAimOptimizer {
+public:
+    CAimOptimizer(CThreadPool& pool, const AimConfig& cfg = DefaultAimConfig());
+
+    // 모든 공이 멈춘 배치에서 isWhiteTurn 쪽 공의 샷. 득점하는 샷을 찾으면 그 회차에서 끝냄.
+    // 여러 스레드에서 동시에 불러도 됨 (rng 는 부르는 쪽 것).
+    // budgetMs > 0 이면 그 시간이 지난 뒤로는 회차를 더 돌지 않음 (1 회차는 항상 끝까지).
+    AimShot optimize(const SimWorld& world, int isWhiteTurn, std::mt19937& rng, double budgetMs = 0);
+
+private:
+    struct Sample {
+        float angle, power;
+        float fitness;
+        int   score;
+    };
+
+    void evaluate(const SimWorld& world, int shooter, int isWhiteTurn, Sample& s) const;
+
+    CThreadPool& m_pool;
+    AimConfig    m_cfg;
+};
+
+#endif // __aimOptimizerH__
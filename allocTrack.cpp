@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: allocTrack.cpp
+//
+// Desc: 전역 operator new/delete 교체와 구간별 할당 수 (USE_ALLOC_TRACK 빌드만)
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "allocTrack.h"
+
+#ifdef USE_ALLOC_TRACK
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+// 구간 이름별 누적. 고정 크기라 기록하면서 힙을 쓰지 않음.
+struct AllocStat {
+    const char* name;
+    size_t      scopes;       // 들어간 횟수
+    size_t      count, bytes;
+    size_t      violations;
+    bool        forbid;
+};
+
+static const int MAX_ALLOC_STATS = 32;
+
+static AllocStat   s_stats[MAX_ALLOC_STATS];
+static int         s_statCount = 0;
+static std::mutex  s_statMutex;
+
+static std::atomic<size_t>           s_total(0);
+static std::atomic<size_t>           s_violations(0);
+static std::atomic<AllocFailHandler> s_failHandler(NULL);
+
+static thread_local CAllocScope* t_scope = NULL;
+static thread_local size_t       t_count = 0;
+
+CAllocScope::CAllocScope(const char* name, bool forbid)
+    : m_name(name), m_forbid(forbid || (t_scope && t_scope->m_forbid)), m_count(0), m_bytes(0),
+      m_violations(0), m_parent(t_scope)
+{
+    t_scope = this;
+}
+
+CAllocScope::~CAllocScope()
+{
+    t_scope = m_parent;
+
+    std::lock_guard<std::mutex> lock(s_statMutex);
+    AllocStat* s = NULL;
+    for (int i = 0; i < s_statCount && !s; i++) {
+        if (s_stats[i].name == m_name || strcmp(s_stats[i].name, m_name) == 0) s = &s_stats[i];
+    }
+    if (!s) {
+        if (s_statCount == MAX_ALLOC_STATS) return;
+        s = &s_stats[s_statCount++];
+        s->name = m_name;
+    }
+    s->scopes++;
+    s->count += m_count;
+    s->bytes += m_bytes;
+    s->violations += m_violations;
+    s->forbid = s->forbid || m_forbid;
+}
+
+void CAllocScope::onAlloc(size_t bytes)
+{
+    s_total.fetch_add(1, std::memory_order_relaxed);
+    t_count++;
+    CAllocScope* scope = t_scope;
+    if (!scope) return;
+    scope->m_count++;
+    scope->m_bytes += bytes;
+    if (scope->m_forbid) {
+        scope->m_violations++;
+        s_violations.fetch_add(1, std::memory_order_relaxed);
+        AllocFailHandler handler = s_failHandler.load();
+        if (handler) handler(scope->m_name, bytes);
+    }
+}
+
+size_t allocTotal() { return s_total.load(std::memory_order_relaxed); }
+size_t allocThreadCount() { return t_count; }
+size_t allocViolations() { return s_violations.load(std::memory_order_relaxed); }
+void allocSetFailHandler(AllocFailHandler handler) { s_failHandler.store(handler); }
+
+void allocReport(FILE* fp)
+{
+    std::lock_guard<std::mutex> lock(s_statMutex);
+    fprintf(fp, "%-16s %10s %12s %14s %10s\n", "scope", "entered", "allocs", "bytes", "violations");
+    for (int i = 0; i < s_statCount; i++) {
+        const AllocStat& s = s_stats[i];
+        fprintf(fp, "%-16s %10zu %12zu %14zu %10s\n", s.name, s.scopes, s.count, s.bytes,
+                s.forbid ? (s.violations ? "FAIL" : "0") : "-");
+        if (s.violations) fprintf(fp, "  %zu allocation(s) in a no-allocation scope\n", s.violations);
+    }
+    fprintf(fp, "total allocs %zu, violations %zu\n", allocTotal(), allocViolations());
+}
+
+// 전역 operator new/delete. 크기와 상관없이 한 번 부를 때마다 셈.
+void* operator new(size_t size)
+{
+    CAllocScope::onAlloc(size);
+    if (size == 0) size = 1;
+    for (;;) {
+        void* p = malloc(size);
+        if (p) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return NULL;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return operator new(size, std::nothrow); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+#endif // USE_ALLOC_TRACK
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: allocTrack.h
+//
+// Desc: 힙 할당 (operator new) 추적. USE_ALLOC_TRACK 으로 빌드하고 allocTrack.cpp 를 같이
+//       링크하면 전역 operator new 를 바꿔 끼워, 스레드마다 지금 들어가 있는 구간에 개수/바이트를 셈.
+//       그 밖의 빌드에서는 매크로가 모두 빈 문장.
+//
+//       ALLOC_SCOPE("name");    // 이 블록의 할당을 name 으로 셈 (턴 끝 학습 등)
+//       ALLOC_FORBID("name");   // 셈 + 이 블록 안 (안쪽 구간 포함) 에서 할당하면 위반
+//       allocReport(stdout);    // 구간별 누적. 위반이 있으면 allocViolations() > 0.
+//
+//       구간 이름은 문자열 상수만 (포인터로 구분). 안쪽 구간의 할당은 안쪽에만 셈.
+//       malloc 을 직접 쓰는 곳 (CArena 블록) 과 드라이버 안의 할당은 보이지 않음.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __allocTrackH__
+#define __allocTrackH__
+
+#include <cstddef>
+#include <cstdio>
+
+// 위반이 났을 때 (operator new 안에서) 불림. 힙을 쓰면 안 됨. 기본은 세기만 함.
+typedef void (*AllocFailHandler)(const char* scope, size_t bytes);
+
+#ifdef USE_ALLOC_TRACK
+
+class CAllocScope {
+public:
+    CAllocScope(const char* name, bool forbid);
+    ~CAllocScope();
+
+    static void onAlloc(size_t bytes);   // operator new 에서
+
+private:
+    const char*  m_name;
+    bool         m_forbid;   // 이 구간이나 바깥 구간이 금지
+    size_t       m_count, m_bytes, m_violations;
+    CAllocScope* m_parent;
+};
+
+size_t allocTotal();         // 프로세스 전체 operator new 횟수
+size_t allocThreadCount();   // 이 스레드의 operator new 횟수 (전후 비교용)
+size_t allocViolations();    // 금지 구간 안의 할당 수
+void   allocSetFailHandler(AllocFailHandler handler);   // NULL 이면 기본 (세기만)
+void   allocReport(FILE* fp);
+
+#define ALLOC_CONCAT2(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT2(a, b)
+#define ALLOC_SCOPE(name) CAllocScope ALLOC_CONCAT(allocScope, __LINE__)(name, false)
+#define ALLOC_FORBID(name) CAllocScope ALLOC_CONCAT(allocScope, __LINE__)(name, true)
+
+#else // USE_ALLOC_TRACK
+
+inline size_t allocTotal() { return 0; }
+inline size_t allocThreadCount() { return 0; }
+inline size_t allocViolations() { return 0; }
+inline void   allocSetFailHandler(AllocFailHandler) {}
+inline void   allocReport(FILE*) {}
+
+#define ALLOC_SCOPE(name) ((void)0)
+#define ALLOC_FORBID(name) ((void)0)
+
+#endif // USE_ALLOC_TRACK
+
+#endif // __allocTrackH__
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: arena.h
+//
+// Desc: 결정 한 번 동안 쓰는 탐색 노드용 bump allocator.
+//       alloc 은 포인터만 밀고, reset() 은 처음 블록으로 되돌리기만 함 (O(1)).
+//       블록은 지우지 않고 다음 결정에서 그대로 다시 쓰므로 한 번 커진 뒤로는 힙을 안 씀.
+//       소멸자를 부르지 않으므로 POD 만 담을 것. 한 스레드에서만 사용.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __arenaH__
+#define __arenaH__
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+class CArena {
+public:
+    explicit CArena(size_t blockSize = 64 * 1024)
+        : m_blockSize(blockSize), m_first(NULL), m_current(NULL), m_used(0) {}
+
+    ~CArena()
+    {
+        Block* b = m_first;
+        while (b) {
+            Block* next = b->next;
+            free(b);
+            b = next;
+        }
+    }
+
+    // n 개짜리 배열. 초기화하지 않음.
+    template <typename T>
+    T* alloc(size_t n = 1)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "arena holds POD only");
+        return static_cast<T*>(allocBytes(n * sizeof(T), alignof(T)));
+    }
+
+    void reset()
+    {
+        m_current = m_first;
+        m_used = 0;
+    }
+
+    // 지금까지 잡아 둔 블록 크기의 합
+    size_t capacity() const
+    {
+        size_t total = 0;
+        for (Block* b = m_first; b; b = b->next) total += b->size;
+        return total;
+    }
+
+    CArena(const CArena&) = delete;
+    CArena& operator=(const CArena&) = delete;
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;   // data 크기
+        alignas(std::max_align_t) unsigned char data[1];
+    };
+
+    void* allocBytes(size_t bytes, size_t align)
+    {
+        for (;;) {
+            if (m_current) {
+                size_t offset = (m_used + align - 1) & ~(align - 1);
+                if (offset + bytes <= m_current->size) {
+                    m_used = offset + bytes;
+                    return m_current->data + offset;
+                }
+                // 다음 블록이 이미 있으면 그것부터 (reset 뒤에 다시 채우는 경우)
+                if (m_current->next) {
+                    m_current = m_current->next;
+                    m_used = 0;
+                    continue;
+                }
+            }
+            size_t size = bytes + align > m_blockSize ? bytes + align : m_blockSize;
+            Block* b = static_cast<Block*>(malloc(offsetof(Block, data) + size));
+            if (!b) throw std::bad_alloc();
+            b->next = NULL;
+            b->size = size;
+            if (m_current) m_current->next = b;
+            else m_first = b;
+            m_current = b;
+            m_used = 0;
+        }
+    }
+
+    size_t m_blockSize;
+    Block* m_first;
+    Block* m_current;
+    size_t m_used;
+};
+
+#endif // __arenaH__
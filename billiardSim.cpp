@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: billiardSim.cpp
+//
+// Desc: 화면 없이 돌리는 당구 물리 시뮬레이터
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "billiardSimCore.h"
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+// 복사 몇 번이 가지 하나이므로 작고 memcpy 가능해야 함
+static_assert(std::is_trivially_copyable<SimGame>::value, "SimGame must stay POD");
+static_assert(sizeof(SimGame) <= 128, "SimGame should fit in two cache lines");
+static_assert(CAROM_TABLE.balls <= SIM_BALLS && POOL_TABLE.balls <= SIM_BALLS, "table uses more balls than SimWorld holds");
+
+TableSpec g_customTable = CAROM_TABLE;
+
+void simReset(SimWorld& w) {
+    simcore::reset(w);
+}
+
+unsigned simAwakeMask(const SimWorld& w)
+{
+    return simcore::awakeMask(w);
+}
+
+void simClearHits(SimWorld& w) {
+    simcore::clearHits(w);
+}
+
+// 물리 본체는 billiardSimCore.h (게임/AI 는 float)
+void simStep(SimWorld& w, float dt) {
+    simcore::step(w, dt);
+}
+
+bool simAllStopped(const SimWorld& w) {
+    return simcore::allStopped(w);
+}
+
+int simRun(SimWorld& w, float dt, int maxSteps) {
+    return simcore::run(w, dt, maxSteps);
+}
+
+// 속력 speed 인 공이 앞으로 움직일 수 있는 거리의 상한.
+// 매 step 이동량은 3.3 * dt * |v| 이고 속도는 rate 배씩 줄어드므로 등비급수 합으로 막힘.
+// 벽에 부딪히면 부호만 바뀌고, 위치 보정은 한 번에 한 축만 하므로 두 벽 근처 (구석) 에서는
+// 넘어갔던 만큼 되돌아오는 거리를 한 번 더 더함.
+static float reachBound(const SimBall& b, float speed, float dt) {
+    const float TIME_SCALE = 3.3f;
+    const float xMax = (float)CAROM_TABLE.xMax();
+    const float zMax = (float)CAROM_TABLE.zMax();
+    if (speed == 0) return 0;
+
+    double rate = 1 - (1 - SIM_DECREASE_RATE) * dt * 400;
+    if (rate < 0)
+        rate = 0;
+    rate += 1e-6;   // float 반올림 여유
+    if (rate >= 1) return 1e30f;
+    float reach = (float)(TIME_SCALE * dt * speed * 1.0001 / (1 - rate));
+
+    // 이미 경계 밖에 있으면 다음 보정으로 되돌아오는 거리
+    float outX = fabsf(b.x) - xMax;
+    float outZ = fabsf(b.z) - zMax;
+    if (outX > 0) reach += outX;
+    if (outZ > 0) reach += outZ;
+    if (fabsf(b.x) + reach >= xMax && fabsf(b.z) + reach >= zMax) reach *= 2;
+    return reach;
+}
+
+bool simHitsSettled(const SimWorld& w, float dt) {
+    const float radiusSum = (float)SIM_RADIUS + (float)SIM_RADIUS;
+    const float margin = 1e-4f;
+
+    float gap[SIM_BALLS][SIM_BALLS];
+    float reach[SIM_BALLS];
+    int group[SIM_BALLS];   // 서로 닿을 수 있는 공끼리 묶음
+    for (int i = 0; i < SIM_BALLS; i++) {
+        const SimBall& b = w.ball[i];
+        reach[i] = reachBound(b, sqrtf(b.vx * b.vx + b.vz * b.vz), dt);
+        group[i] = i;
+        for (int j = i + 1; j < SIM_BALLS; j++) {
+            float dx = b.x - w.ball[j].x;
+            float dz = b.z - w.ball[j].z;
+            gap[i][j] = sqrtf(dx * dx + dz * dz) - radiusSum;
+        }
+    }
+
+    // 이미 hit 가 있는 쌍은 또 닿아도 결과가 같지만, 부딪히면서 속도를 주고받으므로
+    // 닿을 수 있는 공끼리는 묶음 전체의 운동 에너지 (충돌에서 보존, 감속으로만 줄어듦) 로
+    // 속력을 다시 잡고, 겹침 보정으로 밀리는 거리까지 두 배로 봄. 묶음이 안 바뀔 때까지 반복.
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (int i = 0; i < SIM_BALLS; i++) {
+            for (int j = i + 1; j < SIM_BALLS; j++) {
+                if (reach[i] + reach[j] + margin < gap[i][j]) continue;
+                // 둘 다 움직일 수 없으면 붙어 있어도 부딪히지 않음 (다른 공과 묶이면 reach 가 다시 잡힘)
+                if (reach[i] == 0 && reach[j] == 0) continue;
+                if (!simHit(w, i, j)) return false;   // 새 충돌이 생길 수 있음
+                if (group[i] == group[j]) continue;
+
+                int from = group[j], to = group[i];
+                for (int k = 0; k < SIM_BALLS; k++) {
+                    if (group[k] == from) group[k] = to;
+                }
+                changed = true;
+            }
+        }
+        if (!changed) break;
+
+        for (int g = 0; g < SIM_BALLS; g++) {
+            float energy = 0;
+            int members = 0;
+            for (int k = 0; k < SIM_BALLS; k++) {
+                if (group[k] != g) continue;
+                energy += w.ball[k].vx * w.ball[k].vx + w.ball[k].vz * w.ball[k].vz;
+                members++;
+            }
+            if (members < 2) continue;
+            for (int k = 0; k < SIM_BALLS; k++) {
+                if (group[k] == g) reach[k] = 2 * reachBound(w.ball[k], sqrtf(energy), dt);
+            }
+        }
+    }
+    return true;
+}
+
+int simRunHits(SimWorld& w, float dt, int maxSteps) {
+    // 검사 비용을 줄이려고 몇 step 마다 한 번만 확인
+    const int CHECK_EVERY = 8;
+    int steps = 0;
+    while (steps < maxSteps && !simAllStopped(w)) {
+        simStep(w, dt);
+        steps++;
+        if (steps % CHECK_EVERY == 0 && simHitsSettled(w, dt)) break;
+    }
+    return steps;
+}
+
+int simSettle(SimWorld& w, float dt, int maxSteps) {
+    return simcore::settle(w, dt, maxSteps);
+}
+
+void simFire(SimWorld& w, int ball, float targetX, float targetZ) {
+    simcore::fire(w, ball, targetX, targetZ);
+}
+
+void simGameReset(SimGame& g, int winScore) {
+    simReset(g.world);
+    g.isWhiteTurn = 1;
+    g.winner = 0;
+    g.winScore = (short)winScore;
+    g.whiteScore = g.yellowScore = 0;
+}
+
+int simGameShot(SimGame& g, float targetX, float targetZ) {
+    int shooter = g.isWhiteTurn == 1 ? BALL_WHITE : BALL_YELLOW;
+    simClearHits(g.world);
+    simFire(g.world, shooter, targetX, targetZ);
+    simRunHits(g.world);
+
+    // CGameSession::updateScore: +1 이면 턴 유지, 아니면 턴 교대 (-1 은 감점)
+    int score = simTurnScore(g.world, g.isWhiteTurn);
+    short& mine = g.isWhiteTurn == 1 ? g.whiteScore : g.yellowScore;
+    if (score != 0) mine = (short)(mine + score);
+    if (score != 1) g.isWhiteTurn = (signed char)-g.isWhiteTurn;
+    simClearHits(g.world);
+
+    if (g.whiteScore >= g.winScore) g.winner = 3;
+    else if (g.yellowScore >= g.winScore) g.winner = 2;
+    return score;
+}
+
+int simTurnScore(const SimWorld& w, int isWhiteTurn) {
+    int shooter, opponent;
+    if (isWhiteTurn == 1) { shooter = BALL_WHITE; opponent = BALL_YELLOW; }
+    else if (isWhiteTurn == -1) { shooter = BALL_YELLOW; opponent = BALL_WHITE; }
+    else return 0;
+
+    bool r1 = simHit(w, shooter, BALL_RED1);
+    bool r2 = simHit(w, shooter, BALL_RED2);
+    if (simHit(w, shooter, opponent) || (!r1 && !r2)) return -1;
+    if (r1 && r2) return 1;
+    return 0;
+}
+
+int simAIPoint(const SimWorld& w) {
+    bool h0 = simHit(w, BALL_YELLOW, BALL_RED1);
+    bool h1 = simHit(w, BALL_YELLOW, BALL_RED2);
+    bool h2 = simHit(w, BALL_YELLOW, BALL_YELLOW);
+    bool h3 = simHit(w, BALL_YELLOW, BALL_WHITE);
+
+    if (h3) return -1;   // 흰공과 부딪히면 파울
+    if (h0 && h1 && !h2) return +2;
+    if ((h0 ^ h1) && !h2) return +1;
+    if (!h0 && !h1 && !h2) return -1;
+    return 0;
+}
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: billiardSim.h
+//
+// Desc: 화면 없이 돌리는 당구 물리 시뮬레이터 (D3D 없음).
+//       CSphere::ballUpdate / hitBy, CWall::hitBy 와 같은 계산을
+//       Display() 와 같은 순서로 고정 시간 간격마다 수행함.
+//       AI 가 샷을 미리 쳐보는 용도.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __billiardSimH__
+#define __billiardSimH__
+
+#include "tableSpec.h"
+
+// ball number 0: r, 1: r, 2: y, 3: w
+enum {
+    BALL_RED1 = 0,
+    BALL_RED2 = 1,
+    BALL_YELLOW = 2,
+    BALL_WHITE = 3,
+    SIM_BALLS = 4,
+    SIM_PAIRS = SIM_BALLS * (SIM_BALLS - 1) / 2,
+};
+
+// 공 쌍 (i < j) 번호: (0,1) (0,2) (0,3) (1,2) (1,3) (2,3) 순서로 0..SIM_PAIRS-1
+inline int simPair(int i, int j) { return i * (2 * SIM_BALLS - i - 1) / 2 + (j - i - 1); }
+
+const double SIM_RADIUS = CAROM_TABLE.radius;              // M_RADIUS
+const double SIM_DECREASE_RATE = CAROM_TABLE.decreaseRate; // DECREASE_RATE
+const float  SIM_TIME_STEP = 0.007f;                       // 10ms 프레임의 timeDelta (EnterMsgLoop 기준)
+const float  SIM_STOP_SPEED = 0.03f;                       // Display() 의 allStopped 기준
+const int    SIM_MAX_STEPS = 20000;
+
+// 시작 배치 (spherePos)
+const float SIM_START_POS[SIM_BALLS][2] = { {-2.7f,0} , {+2.4f,0} , {3.3f, 0} , {-2.7f,-0.9f} };
+
+// 물리 계산의 수 타입 T 로 만든 공/테이블 상태. 게임과 AI 는 float (SimBall, SimWorld),
+// 기준 실행은 double, 기기 간 결정성이 필요하면 Fixed (fixedPoint.h). 계산은 billiardSimCore.h.
+template <class T>
+struct SimBallT {
+    T x, z;
+    T vx, vz;
+};
+
+template <class T>
+struct SimWorldT {
+    SimBallT<T>   ball[SIM_BALLS];
+    unsigned char hit[SIM_BALLS];   // hit[i] 의 bit j: 이번 샷에서 공 i 와 공 j 의 접촉이 시작됨 (CSphere::hit)
+
+    // 접촉 캐시. 접촉은 움직이던 두 공이 닿을 때 (부딪힘, 스침) 시작해서 떨어질 때 끝남.
+    // 붙어서 멈춰 있기만 한 쌍은 접촉이 아니므로 hit 가 켜지지 않고, 둘 다 멈춘 쌍은 검사하지 않음.
+    // 쌍 bit p (simPair) 로: contact 는 접촉 중인 쌍, began/ended 는 마지막 step 에서 시작/끝난 쌍.
+    // eventStep[p] 는 쌍 p 의 마지막 시작 또는 끝 step, impact[p] 는 마지막 시작 때 법선 방향으로 다가오던 속력 (스침은 0).
+    // 샷마다 simClearHits 에서 비우고, 공 위치를 직접 바꾸면 simTouch() 로 비움.
+    unsigned short step;            // simClearHits 이후 step 수
+    unsigned short eventStep[SIM_PAIRS];
+    unsigned char  contact, began, ended;
+    unsigned char  cushionHits[SIM_BALLS];   // 마지막 step 에서 공마다 쿠션에 부딪힌 수
+    T              impact[SIM_PAIRS];
+};
+
+typedef SimBallT<float>  SimBall;
+typedef SimWorldT<float> SimWorld;
+
+// 탐색에서 가지를 칠 때 복사하는 한 판 상태 (공, hit, 턴, 점수). POD 라서 대입이 곧 저장/복원.
+struct SimGame {
+    SimWorld    world;
+    signed char isWhiteTurn;   // 1: 흰 공, -1: 노란 공
+    signed char winner;        // 0: 진행 중, 2: yellow, 3: white
+    short       winScore;
+    short       whiteScore, yellowScore;
+};
+
+void simReset(SimWorld& w);          // 시작 배치, 정지, hit 초기화
+void simClearHits(SimWorld& w);      // hit_initialize (접촉 캐시도 비움)
+inline void simTouch(SimWorld& w) { w.contact = 0; }
+// 움직이는 공 bit (속도가 0 이 아닌 공). 샷 (simFire) 이나 충돌로 속도가 생기면 깨어남.
+unsigned simAwakeMask(const SimWorld& w);
+void simStep(SimWorld& w, float dt); // Display() 한 프레임 분량의 물리
+bool simAllStopped(const SimWorld& w);
+// 모두 멈출 때까지 진행. 진행한 step 수 반환.
+int simRun(SimWorld& w, float dt = SIM_TIME_STEP, int maxSteps = SIM_MAX_STEPS);
+// hit 만 필요할 때: 남은 움직임으로 새 충돌이 생길 수 없으면 멈추기 전에 끝냄.
+// 끝난 뒤 hit 는 simRun 과 같고, 공은 아직 움직이는 중일 수 있음 (simSettle 로 이어서 진행 가능).
+int simRunHits(SimWorld& w, float dt = SIM_TIME_STEP, int maxSteps = SIM_MAX_STEPS);
+// 지금부터 공이 더 갈 수 있는 거리로 보아, 아직 hit 가 없는 쌍이 앞으로도 닿을 수 없으면 true
+bool simHitsSettled(const SimWorld& w, float dt = SIM_TIME_STEP);
+// allStopped 이후 남은 느린 움직임까지 속도가 0 이 될 때까지 진행 (다음 샷 직전 배치)
+int simSettle(SimWorld& w, float dt = SIM_TIME_STEP, int maxSteps = SIM_MAX_STEPS);
+
+// (targetX, targetZ) 를 향해 그 거리만큼의 세기로 발사 (VK_SPACE / AIFireYellowBall 과 같음)
+void simFire(SimWorld& w, int ball, float targetX, float targetZ);
+
+inline bool simHit(const SimWorld& w, int ball, int other) { return (w.hit[ball] >> other) & 1; }
+
+void simGameReset(SimGame& g, int winScore);
+// hit 를 지우고 지금 턴인 공으로 (targetX, targetZ) 를 쳐서 hit 가 정해질 때까지 진행하고 (simRunHits)
+// updateScore 와 같이 점수/턴/승자를 갱신한 뒤 hit 를 지움. getScore 값을 반환.
+// 공은 아직 움직이는 중일 수 있으므로 다음 샷 전에 simSettle(g.world).
+int simGameShot(SimGame& g, float targetX, float targetZ);
+
+// CSphere::getScore. isWhiteTurn == 1 이면 흰 공, -1 이면 노란 공 기준.
+int simTurnScore(const SimWorld& w, int isWhiteTurn);
+// calculateAIPoint (노란 공 기준 보상)
+int simAIPoint(const SimWorld& w);
+
+#endif // __billiardSimH__
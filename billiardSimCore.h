@@ -0,0 +1,559 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: billiardSimCore.h
+//
+// Desc: 수 타입 T 에 대한 당구 물리 (billiardSim 의 step/run/fire 본체).
+//       T 마다 다른 부분 (변환, sqrt, 감속 곱, 발사 방향의 삼각함수) 은 SimMath<T> 에 모음.
+//       Fixed 는 모두 정수 연산이라 빌드/기기가 달라도 궤적과 hit 가 비트까지 같음 (결정적 모드).
+//       float 은 원래 코드와 같은 값이 나오도록 상수는 double 에서 T 로 바꿔 쓰고,
+//       double 상수와의 비교는 SimMath 의 above/atLeast/atMost 로 원래 (double 로 비교) 와 같게 함.
+//       테이블 크기/반지름/감속은 템플릿 인자 S (tableSpec.h, 기본 CAROM_TABLE) 에서.
+//       S 에 선분 쿠션 (rails) 이 있으면 네 벽 대신 railsHitBy (float 는 SSE 로 공 4 개를 한 번에).
+//       billiardSim.cpp 가 float 로, simTool 이 세 타입 모두로 씀.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __billiardSimCoreH__
+#define __billiardSimCoreH__
+
+#include "billiardSim.h"
+#include "fixedPoint.h"
+#include "tableSpec.h"
+#include <cmath>
+#include <cstring>
+
+#if (defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)) && !defined(SIM_NO_SIMD)
+#define SIM_SSE 1
+#include <emmintrin.h>
+#endif
+
+// ballUpdate 의 감속 비율 (한 step 에 속도에 곱하는 값)
+inline double simDecayRate(double dt, double decreaseRate)
+{
+    double rate = 1 - (1 - decreaseRate) * dt * 400;
+    if (rate < 0)
+        rate = 0;
+    return rate;
+}
+
+// simFire 의 속도: (dx, dz) 방향으로 그 거리만큼 (atan2 로 각도, cos/sin 으로 다시 성분)
+inline void simShotVelocity(double dx, double dz, double& vx, double& vz)
+{
+    double theta = atan2(dz, dx);
+    double dist = sqrt(pow(dx, 2) + pow(dz, 2));
+    vx = dist * cos(theta);
+    vz = dist * sin(theta);
+}
+
+template <class T> struct SimMath;
+
+template <>
+struct SimMath<float> {
+    typedef double Rate;
+    static float fromDouble(double d) { return (float)d; }
+    static double toDouble(float v) { return v; }
+    static float sqrt(float v) { return sqrtf(v); }
+    static float abs(float v) { return fabsf(v); }
+    // double 상수 c 와의 비교 (원래 코드의 float -> double 비교)
+    static bool above(float v, double c) { return v > c; }
+    static bool atLeast(float v, double c) { return v >= c; }
+    static bool atMost(float v, double c) { return v <= c; }
+    // 중심 거리 제곱이 d2 인 두 공이 닿았는지 (sqrt(d2) <= radiusSum). 닿았으면 distance 도.
+    static bool touching(float d2, float radiusSum, float& distance)
+    {
+        distance = sqrtf(d2);
+        return !(distance > radiusSum);
+    }
+    // 한 step 의 이동 = timeScale(dt) * v. 원래 코드의 (TIME_SCALE * timeDiff) * v 와 같은 순서.
+    typedef float Step;
+    static Step timeScale(float dt) { return 3.3f * dt; }
+    static float travel(float v, Step k) { return k * v; }
+    // 감속은 원래 코드처럼 float 속도를 double rate 로 곱한 뒤 float 로
+    static Rate decayRate(float dt, double decreaseRate) { return simDecayRate(dt, decreaseRate); }
+    static float scale(float v, Rate rate) { return (float)(v * rate); }
+    static void shotVelocity(float dx, float dz, float& vx, float& vz)
+    {
+        double x, z;
+        simShotVelocity(dx, dz, x, z);
+        vx = (float)x;
+        vz = (float)z;
+    }
+};
+
+template <>
+struct SimMath<double> {
+    typedef double Rate;
+    static double fromDouble(double d) { return d; }
+    static double toDouble(double v) { return v; }
+    static double sqrt(double v) { return std::sqrt(v); }
+    static double abs(double v) { return std::fabs(v); }
+    static bool above(double v, double c) { return v > c; }
+    static bool atLeast(double v, double c) { return v >= c; }
+    static bool atMost(double v, double c) { return v <= c; }
+    static bool touching(double d2, double radiusSum, double& distance)
+    {
+        distance = std::sqrt(d2);
+        return !(distance > radiusSum);
+    }
+    typedef double Step;
+    static Step timeScale(double dt) { return 3.3 * dt; }
+    static double travel(double v, Step k) { return k * v; }
+    static Rate decayRate(double dt, double decreaseRate) { return simDecayRate(dt, decreaseRate); }
+    static double scale(double v, Rate rate) { return v * rate; }
+    static void shotVelocity(double dx, double dz, double& vx, double& vz) { simShotVelocity(dx, dz, vx, vz); }
+};
+
+// 결정적 모드: 물리 계산에 부동소수점을 쓰지 않음 (double 은 컴파일 때 정해지는 상수에만)
+template <>
+struct SimMath<Fixed> {
+    static Fixed fromDouble(double d) { return Fixed::fromDouble(d); }
+    static double toDouble(Fixed v) { return v.toDouble(); }
+    static Fixed sqrt(Fixed v) { return fixedSqrt(v); }
+    static Fixed abs(Fixed v) { return v.raw < 0 ? -v : v; }
+    // c 는 상수라 floor/ceil 은 컴파일 때 계산되고 실행 중에는 정수 비교만 남음
+    static bool above(Fixed v, double c) { return v.raw > std::floor(c * Fixed::ONE); }
+    static bool atLeast(Fixed v, double c) { return v.raw >= std::ceil(c * Fixed::ONE); }
+    static bool atMost(Fixed v, double c) { return v.raw <= std::floor(c * Fixed::ONE); }
+    // 반올림한 sqrt 가 R 이하 <=> d2 (Q48) <= R² + R. 떨어진 쌍은 sqrt 없이 정수 비교로 끝남.
+    static bool touching(Fixed d2, Fixed radiusSum, Fixed& distance)
+    {
+        int64_t r = radiusSum.raw;
+        if (d2.raw > 0 && ((int64_t)d2.raw << Fixed::FRAC_BITS) > r * r + r) return false;
+        distance = fixedSqrt(d2);
+        return true;
+    }
+    // 한 step 의 이동 계수 (Q36) 와 감속 비율 (Q30) 은 Q8.24 보다 정밀하게 들고 감.
+    // 게임 dt (SIM_TIME_STEP = 0.007) 는 Q8.24 로 정확히 나타나지 않아 (117441 / 2^24, 4e-6 배 김)
+    // 그대로 곱하면 매 step 같은 쪽으로 어긋나 멈춘 위치가 기준과 멀어지므로, 그 dt 일 때는
+    // 반올림 전 값으로 float 쪽과 같은 계수를 만듦. 계수는 상수에서만 나오므로 결과는 여전히 정수 연산.
+    typedef int64_t Step;
+    static int64_t toQ(double d, int bits) { return (int64_t)std::floor(d * (double)(1LL << bits) + 0.5); }
+    static bool gameStep(Fixed dt) { return dt == Fixed::fromDouble(SIM_TIME_STEP); }
+    static Step timeScale(Fixed dt)
+    {
+        if (gameStep(dt)) return toQ(3.3f * SIM_TIME_STEP, 36);   // 원래 코드의 float TIME_SCALE * timeDiff
+        return (int64_t)dt.raw * toQ(3.3, 12);                      // Q24 x Q12
+    }
+    static Fixed travel(Fixed v, Step k) { return Fixed::fromRaw((int32_t)((v.raw * k + (1LL << 35)) >> 36)); }
+    typedef int64_t Rate;
+    static Rate decayRate(Fixed dt, double decreaseRate)
+    {
+        const int64_t one = 1LL << 30;
+        int64_t rate = gameStep(dt) ? toQ(simDecayRate(SIM_TIME_STEP, decreaseRate), 30)
+                                    : one - (((int64_t)dt.raw * Fixed::fromDouble((1 - decreaseRate) * 400).raw) >> 18);
+        return rate < 0 ? 0 : rate;
+    }
+    static Fixed scale(Fixed v, Rate rate) { return Fixed::fromRaw((int32_t)((v.raw * rate + (1LL << 29)) >> 30)); }
+    static void shotVelocity(Fixed dx, Fixed dz, Fixed& vx, Fixed& vz)
+    {
+        Fixed theta = fixedAtan2(dz, dx);
+        Fixed dist = fixedHypot(dx, dz);
+        Fixed s, c;
+        fixedSinCos(theta, s, c);
+        vx = dist * c;
+        vz = dist * s;
+    }
+};
+
+// 선분 쿠션 검사를 건너뛰는 안쪽 범위의 여유 (반올림으로 경계의 판정이 바뀌지 않게)
+const double SIM_RAIL_MARGIN = 1e-3;
+
+namespace simcore {
+
+template <class T>
+inline T C(double d) { return SimMath<T>::fromDouble(d); }
+
+// hit 와 접촉 캐시를 다른 타입의 상태로 (결정적 모드에서 float 쪽 점수 처리를 따를 때)
+template <class T, class U>
+void copyContacts(const SimWorldT<U>& from, SimWorldT<T>& to)
+{
+    memcpy(to.hit, from.hit, sizeof(to.hit));
+    to.step = from.step;
+    memcpy(to.eventStep, from.eventStep, sizeof(to.eventStep));
+    to.contact = from.contact;
+    to.began = from.began;
+    to.ended = from.ended;
+    memcpy(to.cushionHits, from.cushionHits, sizeof(to.cushionHits));
+    for (int p = 0; p < SIM_PAIRS; p++) to.impact[p] = C<T>(SimMath<U>::toDouble(from.impact[p]));
+}
+
+// 다른 타입의 상태를 옮겨 옴 (같은 배치를 타입별로 돌려 볼 때)
+template <class T, class U>
+void convert(const SimWorldT<U>& from, SimWorldT<T>& to)
+{
+    for (int i = 0; i < SIM_BALLS; i++) {
+        to.ball[i].x = C<T>(SimMath<U>::toDouble(from.ball[i].x));
+        to.ball[i].z = C<T>(SimMath<U>::toDouble(from.ball[i].z));
+        to.ball[i].vx = C<T>(SimMath<U>::toDouble(from.ball[i].vx));
+        to.ball[i].vz = C<T>(SimMath<U>::toDouble(from.ball[i].vz));
+    }
+    copyContacts(from, to);
+}
+
+// hit_initialize. 새 샷은 접촉 없이 시작 (붙어 있던 공도 다시 부딪혀야 hit).
+template <class T>
+void clearHits(SimWorldT<T>& w)
+{
+    memset(w.hit, 0, sizeof(w.hit));
+    w.step = 0;
+    memset(w.eventStep, 0, sizeof(w.eventStep));
+    w.contact = w.began = w.ended = 0;
+    memset(w.cushionHits, 0, sizeof(w.cushionHits));
+    for (int p = 0; p < SIM_PAIRS; p++) w.impact[p] = C<T>(0);
+}
+
+// 시작 배치는 4구 테이블의 spherePos 를 테이블 크기에 맞춰 늘림 (4구 테이블이면 그대로)
+template <const TableSpec& S = CAROM_TABLE, class T>
+void reset(SimWorldT<T>& w)
+{
+    for (int i = 0; i < SIM_BALLS; i++) {
+        w.ball[i].x = C<T>(SIM_START_POS[i][0] * (S.halfX / CAROM_TABLE.halfX));
+        w.ball[i].z = C<T>(SIM_START_POS[i][1] * (S.halfZ / CAROM_TABLE.halfZ));
+        w.ball[i].vx = w.ball[i].vz = C<T>(0);
+    }
+    clearHits(w);
+}
+
+template <const TableSpec& S = CAROM_TABLE, class T>
+unsigned awakeMask(const SimWorldT<T>& w)
+{
+    unsigned mask = 0;
+    for (int i = 0; i < S.balls; i++) {
+        if (w.ball[i].vx != C<T>(0) || w.ball[i].vz != C<T>(0)) mask |= 1u << i;
+    }
+    return mask;
+}
+
+// CSphere::ballUpdate
+template <const TableSpec& S = CAROM_TABLE, class T>
+void ballUpdate(SimBallT<T>& b, T timeDiff)
+{
+    typedef SimMath<T> M;
+    if (M::above(M::abs(b.vx), 0.01) || M::above(M::abs(b.vz), 0.01)) {
+        typename M::Step k = M::timeScale(timeDiff);   // TIME_SCALE (3.3) * timeDiff
+        T tX = b.x + M::travel(b.vx, k);
+        T tZ = b.z + M::travel(b.vz, k);
+
+        // 벽 쪽 위치 보정 (원래 코드처럼 한 번에 한 축만). 선분 쿠션은 railsHitBy 가 밀어냄.
+        if (!S.railCount) {
+            if (M::atLeast(tX, S.xMax()))
+                tX = C<T>(S.xMax());
+            else if (M::atMost(tX, -S.halfX + S.radius))
+                tX = C<T>(-S.halfX + S.radius);
+            else if (M::atMost(tZ, -S.halfZ + S.radius))
+                tZ = C<T>(-S.halfZ + S.radius);
+            else if (M::atLeast(tZ, S.zMax()))
+                tZ = C<T>(S.zMax());
+        }
+
+        b.x = tX;
+        b.z = tZ;
+    }
+    else {
+        b.vx = b.vz = C<T>(0);
+    }
+    typename M::Rate rate = M::decayRate(timeDiff, S.decreaseRate);
+    b.vx = M::scale(b.vx, rate);
+    b.vz = M::scale(b.vz, rate);
+}
+
+// CWall::hitBy. wall 0: 위 (z = wallZ, 4구 테이블은 3.06), 1: 아래, 2: 오른쪽 (x = wallX, 4.56), 3: 왼쪽.
+// walls 의 bit k 인 벽만 검사. 한 공에 대한 네 벽 검사는 서로 순서가 바뀌어도 결과가 같음.
+// 벽 쪽으로 가다 튕긴 수를 반환 (겹친 채 멀어지는 중에 뒤집힌 것은 세지 않음).
+template <const TableSpec& S = CAROM_TABLE, class T>
+int wallsHitBy(unsigned walls, SimBallT<T>& b)
+{
+    const T zero = C<T>(0);
+    const T r = C<T>(S.radius);
+    const T half = C<T>(S.cushion) / C<T>(2);
+    int hits = 0;
+    if ((walls & 1) && b.z + r >= C<T>(S.wallZ()) - half) { hits += b.vz > zero; b.vz = -b.vz; }
+    if ((walls & 2) && b.z - r <= -C<T>(S.wallZ()) + half) { hits += b.vz < zero; b.vz = -b.vz; }
+    if ((walls & 4) && b.x + r >= C<T>(S.wallX()) - half) { hits += b.vx > zero; b.vx = -b.vx; }
+    if ((walls & 8) && b.x - r <= -C<T>(S.wallX()) + half) { hits += b.vx < zero; b.vx = -b.vx; }
+    return hits;
+}
+
+// 선분 쿠션 하나와 공 하나. 조각 안쪽 (0 <= t <= length) 이면 면의 법선으로, tip 이면 꼭짓점에서
+// 공 중심 쪽으로 반사하고 반지름만큼 밀어냄. 다가오는 중일 때만 반사 (원래 벽은 겹치면 항상 뒤집음).
+// railsHitBy 의 SSE 판과 같은 순서로 계산해서 float 결과가 비트까지 같음. 반사했으면 true.
+template <class T>
+bool railHitBy(const RailSegment& seg, SimBallT<T>& b, T r)
+{
+    const T zero = C<T>(0);
+    T rx = b.x - C<T>(seg.ax), rz = b.z - C<T>(seg.az);
+    T t = rx * C<T>(seg.ux) + rz * C<T>(seg.uz);
+    T d = rx * C<T>(seg.nx) + rz * C<T>(seg.nz);
+    T nx, nz, pen;
+    if (t >= zero && t <= C<T>(seg.length)) {
+        if (!(d < r && d > -r)) return false;
+        nx = C<T>(seg.nx);
+        nz = C<T>(seg.nz);
+        pen = r - d;
+    }
+    else {
+        // 앞 조각 끝을 지나고 이 조각 시작 전인 부채꼴만 (안쪽 검사와 겹치지 않게)
+        if (!seg.tip || !(t < zero) || !(rx * C<T>(seg.prevX) + rz * C<T>(seg.prevZ) > zero)) return false;
+        T dist = SimMath<T>::sqrt(rx * rx + rz * rz);
+        if (!(dist < r && dist > zero)) return false;
+        nx = rx / dist;
+        nz = rz / dist;
+        pen = r - dist;
+    }
+    T vn = b.vx * nx + b.vz * nz;
+    bool reflect = vn < zero;
+    if (reflect) {
+        T k = vn + vn;
+        b.vx -= k * nx;
+        b.vz -= k * nz;
+    }
+    b.x += nx * pen;
+    b.z += nz * pen;
+    return reflect;
+}
+
+// 쿠션 직사각형 안쪽으로 반지름 이상 들어와 있으면 어느 선분에도 닿을 수 없음
+template <const TableSpec& S, class T>
+bool railsClear(const SimBallT<T>& b)
+{
+    typedef SimMath<T> M;
+    return M::atMost(M::abs(b.x), S.xMax() - SIM_RAIL_MARGIN) && M::atMost(M::abs(b.z), S.zMax() - SIM_RAIL_MARGIN);
+}
+
+// balls 의 bit i 인 공을 모든 선분 쿠션에 대해 (조각 순서대로, 구석에서는 두 조각이 차례로 반사)
+template <const TableSpec& S, class T>
+void railsHitBy(SimWorldT<T>& w, unsigned balls)
+{
+    const T r = C<T>(S.radius);
+    for (int i = 0; i < S.balls; i++) {
+        if (!(balls & (1u << i)) || railsClear<S>(w.ball[i])) continue;
+        for (int k = 0; k < S.railCount; k++) w.cushionHits[i] += railHitBy(S.rails[k], w.ball[i], r);
+    }
+}
+
+#ifdef SIM_SSE
+inline __m128 simSelect(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// float: 공 4 개를 lane 4 개로 (SimBall 4 개 = 4x4 float 를 전치해서 x, z, vx, vz).
+// 선분 하나에 공 전부를 한 번에 검사하고, 닿은 lane 이 없으면 다음 선분으로.
+template <const TableSpec& S>
+void railsHitBy(SimWorldT<float>& w, unsigned balls)
+{
+    static_assert(SIM_BALLS == 4, "one SSE lane per ball");
+    const float R = (float)S.radius;
+
+    unsigned check = 0;
+    for (int i = 0; i < S.balls; i++) {
+        if ((balls & (1u << i)) && !railsClear<S>(w.ball[i])) check |= 1u << i;
+    }
+    if (!check) return;
+
+    float* p = &w.ball[0].x;
+    __m128 x = _mm_loadu_ps(p), z = _mm_loadu_ps(p + 4), vx = _mm_loadu_ps(p + 8), vz = _mm_loadu_ps(p + 12);
+    _MM_TRANSPOSE4_PS(x, z, vx, vz);
+
+    const __m128i bit = _mm_set_epi32(8, 4, 2, 1);
+    const __m128 active = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32((int)check), bit), bit));
+    const __m128 zero = _mm_setzero_ps(), r = _mm_set1_ps(R), negR = _mm_set1_ps(-R);
+
+    for (int k = 0; k < S.railCount; k++) {
+        const RailSegment& seg = S.rails[k];
+        const __m128 snx = _mm_set1_ps((float)seg.nx), snz = _mm_set1_ps((float)seg.nz);
+        __m128 rx = _mm_sub_ps(x, _mm_set1_ps((float)seg.ax));
+        __m128 rz = _mm_sub_ps(z, _mm_set1_ps((float)seg.az));
+        __m128 t = _mm_add_ps(_mm_mul_ps(rx, _mm_set1_ps((float)seg.ux)), _mm_mul_ps(rz, _mm_set1_ps((float)seg.uz)));
+        __m128 d = _mm_add_ps(_mm_mul_ps(rx, snx), _mm_mul_ps(rz, snz));
+        __m128 inside = _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmple_ps(t, _mm_set1_ps((float)seg.length)));
+        __m128 face = _mm_and_ps(inside, _mm_and_ps(_mm_cmplt_ps(d, r), _mm_cmpgt_ps(d, negR)));
+        __m128 nx = snx, nz = snz, pen = _mm_sub_ps(r, d);
+        __m128 hit = face;
+        if (seg.tip) {
+            __m128 fan = _mm_and_ps(_mm_cmplt_ps(t, zero),
+                _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(rx, _mm_set1_ps((float)seg.prevX)),
+                                        _mm_mul_ps(rz, _mm_set1_ps((float)seg.prevZ))), zero));
+            __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(rz, rz)));
+            __m128 corner = _mm_and_ps(_mm_andnot_ps(inside, fan), _mm_and_ps(_mm_cmplt_ps(dist, r), _mm_cmpgt_ps(dist, zero)));
+            nx = simSelect(corner, _mm_div_ps(rx, dist), nx);
+            nz = simSelect(corner, _mm_div_ps(rz, dist), nz);
+            pen = simSelect(corner, _mm_sub_ps(r, dist), pen);
+            hit = _mm_or_ps(hit, corner);
+        }
+        hit = _mm_and_ps(hit, active);
+        if (!_mm_movemask_ps(hit)) continue;
+
+        __m128 vn = _mm_add_ps(_mm_mul_ps(vx, nx), _mm_mul_ps(vz, nz));
+        __m128 reflect = _mm_and_ps(hit, _mm_cmplt_ps(vn, zero));
+        __m128 k2 = _mm_add_ps(vn, vn);
+        unsigned bounced = (unsigned)_mm_movemask_ps(reflect);
+        for (int i = 0; bounced; i++, bounced >>= 1) w.cushionHits[i] += bounced & 1;
+        vx = simSelect(reflect, _mm_sub_ps(vx, _mm_mul_ps(k2, nx)), vx);
+        vz = simSelect(reflect, _mm_sub_ps(vz, _mm_mul_ps(k2, nz)), vz);
+        x = simSelect(hit, _mm_add_ps(x, _mm_mul_ps(nx, pen)), x);
+        z = simSelect(hit, _mm_add_ps(z, _mm_mul_ps(nz, pen)), z);
+    }
+
+    _MM_TRANSPOSE4_PS(x, z, vx, vz);
+    _mm_storeu_ps(p, x);
+    _mm_storeu_ps(p + 4, z);
+    _mm_storeu_ps(p + 8, vx);
+    _mm_storeu_ps(p + 12, vz);
+}
+#endif
+
+// CSphere::hitBy (this = i, ball = j). 접촉 캐시도 갱신.
+// 닿았으면 true
+template <const TableSpec& S = CAROM_TABLE, class T>
+bool ballHitBy(SimWorldT<T>& w, int i, int j)
+{
+    SimBallT<T>& a = w.ball[i];
+    SimBallT<T>& b = w.ball[j];
+    const T zero = C<T>(0);
+    const T radiusSum = C<T>(S.radius) + C<T>(S.radius);
+    const int pair = simPair(i, j);
+    const unsigned char bit = (unsigned char)(1 << pair);
+
+    T dx = a.x - b.x;
+    T dz = a.z - b.z;
+    T distance;
+    if (!SimMath<T>::touching(dx * dx + dz * dz, radiusSum, distance)) {
+        if (w.contact & bit) {
+            w.contact &= (unsigned char)~bit;
+            w.ended |= bit;
+            w.eventStep[pair] = w.step;
+        }
+        return false;
+    }
+
+    T nx = zero, nz = zero;
+    if (distance > zero) {
+        nx = dx / distance;
+        nz = dz / distance;
+    }
+
+    // relative: 법선 방향 상대 속도, 음수면 다가오는 중
+    T relative = (a.vx - b.vx) * nx + (a.vz - b.vz) * nz;
+
+    // 움직이던 쌍이 새로 닿았으면 접촉 시작: hasIntersected 로 서로의 hit 갱신.
+    // 프레임 사이에 스치고 지나가 이미 멀어지는 중에 겹친 것도 원래 hitBy 처럼 닿은 것으로 침.
+    if (!(w.contact & bit) && relative != zero) {
+        w.contact |= bit;
+        w.began |= bit;
+        w.eventStep[pair] = w.step;
+        w.impact[pair] = relative < zero ? -relative : zero;
+        w.hit[j] |= (unsigned char)(1 << i);
+        w.hit[i] |= (unsigned char)(1 << j);
+    }
+
+    // 두 공이 서로 멀어지는 중이면 무시
+    if (relative > zero)
+        return true;
+
+    // 질량이 같은 완전탄성 충돌: 법선 성분 교환
+    T v1n = a.vx * nx + a.vz * nz;
+    T v2n = b.vx * nx + b.vz * nz;
+    T p = v1n - v2n;
+    a.vx -= nx * p;
+    a.vz -= nz * p;
+    b.vx += nx * p;
+    b.vz += nz * p;
+
+    // 살짝 겹쳐진 공 위치 보정
+    T overlap = (radiusSum - distance) * C<T>(0.5);
+    if (overlap > zero) {
+        a.x += nx * overlap;
+        a.z += nz * overlap;
+        b.x -= nx * overlap;
+        b.z -= nz * overlap;
+    }
+    return true;
+}
+
+template <const TableSpec& S = CAROM_TABLE, class T>
+void step(SimWorldT<T>& w, T dt)
+{
+    unsigned awake = awakeMask<S>(w);
+    if (w.step < 0xffff) w.step++;
+    w.began = w.ended = 0;
+    memset(w.cushionHits, 0, sizeof(w.cushionHits));
+
+    // 모두 잠들었으면 위치도 속도도 접촉도 그대로
+    if (!awake) return;
+
+    // 멈춘 공은 ballUpdate 도 벽 반사도 결과가 그대로이므로 (0 의 부호만 바뀜) 건너뜀.
+    // Display() 는 공 i 이동 후 벽 i 를 모든 공에 검사하므로, 공 i 는 벽 0..i-1 을 이동 전에,
+    // 벽 i.. 를 이동 후에 봄. 공마다 그 순서대로 처리.
+    // 선분 쿠션은 모두 옮긴 뒤 한 번에.
+    if (S.railCount) {
+        for (int i = 0; i < S.balls; i++) {
+            if (awake & (1u << i)) ballUpdate<S>(w.ball[i], dt);
+        }
+        railsHitBy<S>(w, awake);
+    }
+    else {
+        for (int i = 0; i < S.balls; i++) {
+            if (!(awake & (1u << i))) continue;
+            unsigned before = ((1u << i) - 1) & 0xf;
+            int hits = wallsHitBy<S>(before, w.ball[i]);
+            ballUpdate<S>(w.ball[i], dt);
+            hits += wallsHitBy<S>(0xf & ~before, w.ball[i]);
+            w.cushionHits[i] = (unsigned char)hits;
+        }
+    }
+
+    // ballUpdate 에서 멈춘 공은 이번 step 까지는 깨어 있는 것으로 봄 (Display() 와 같은 검사).
+    // 앞 쌍에서 닿은 공은 바로 깨워서 뒤 쌍도 원래대로 검사.
+    // 둘 다 잠든 쌍은 위치도 속도도 그대로라 접촉 상태가 바뀔 수 없으므로 건너뜀.
+    for (int i = 0; i < S.balls; i++) {
+        for (int j = i + 1; j < S.balls; j++) {
+            if (!((awake >> i | awake >> j) & 1)) continue;
+            if (ballHitBy<S>(w, i, j)) awake |= (1u << i) | (1u << j);
+        }
+    }
+}
+
+template <const TableSpec& S = CAROM_TABLE, class T>
+bool allStopped(const SimWorldT<T>& w)
+{
+    typedef SimMath<T> M;
+    for (int i = 0; i < S.balls; i++) {
+        if (M::above(M::abs(w.ball[i].vx), SIM_STOP_SPEED) || M::above(M::abs(w.ball[i].vz), SIM_STOP_SPEED))
+            return false;
+    }
+    return true;
+}
+
+template <const TableSpec& S = CAROM_TABLE, class T>
+int run(SimWorldT<T>& w, T dt, int maxSteps)
+{
+    int steps = 0;
+    while (steps < maxSteps && !allStopped<S>(w)) {
+        step<S>(w, dt);
+        steps++;
+    }
+    return steps;
+}
+
+template <const TableSpec& S = CAROM_TABLE, class T>
+int settle(SimWorldT<T>& w, T dt, int maxSteps)
+{
+    int steps = 0;
+    for (; steps < maxSteps; steps++) {
+        if (!awakeMask<S>(w)) break;
+        step<S>(w, dt);
+    }
+    return steps;
+}
+
+template <class T>
+void fire(SimWorldT<T>& w, int ball, T targetX, T targetZ)
+{
+    SimBallT<T>& b = w.ball[ball];
+    SimMath<T>::shotVelocity(targetX - b.x, targetZ - b.z, b.vx, b.vz);
+}
+
+} // namespace simcore
+
+#endif // __billiardSimCoreH__
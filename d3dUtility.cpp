@@ -11,6 +11,84 @@
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "d3dUtility.h"
+#include "framePacer.h"
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002   // Windows 10 1803 이후
+#endif
+
+//
+// 바뀐 것이 있을 때만 그리는 메시지 루프. 그릴 것이 없으면 입력이 올 때까지,
+// 애니메이션 중이면 다음 프레임 시각까지 waitable timer 로 잠듦.
+// wake 가 신호되면 (시뮬레이션 스레드가 바뀐 상태를 내보냄) 입력이 없어도 깨어나 FRAME_SNAPSHOT 을 그림.
+//
+static int PacedMsgLoop(bool (*ptr_display)(float timeDelta), CFramePacer& pacer, HANDLE wake)
+{
+	MSG msg;
+	::ZeroMemory(&msg, sizeof(MSG));
+
+	// 고해상도 타이머가 없는 OS 에서는 시스템 타이머 해상도를 1ms 로 올려서 씀
+	bool raisedPeriod = false;
+	HANDLE timer = ::CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if( !timer )
+	{
+		raisedPeriod = (::timeBeginPeriod(1) == TIMERR_NOERROR);
+		timer = ::CreateWaitableTimer(NULL, TRUE, NULL);
+	}
+
+	double lastTime = d3d::TimeMs();
+
+	while(msg.message != WM_QUIT)
+	{
+		if(::PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
+		{
+			::TranslateMessage(&msg);
+			::DispatchMessage(&msg);
+			continue;
+		}
+
+		// 자동 리셋 이벤트라 여기서 확인하면 신호가 지워짐
+		if( wake && ::WaitForSingleObject(wake, 0) == WAIT_OBJECT_0 )
+			pacer.markDirty(FRAME_SNAPSHOT);
+
+		double currTime = d3d::TimeMs();
+		double wait = pacer.waitMs(currTime);
+		HANDLE handles[2];
+		DWORD count = 0;
+		if( wake )
+			handles[count++] = wake;
+		if( wait == FRAME_WAIT_INPUT || (wait > 0 && !timer) )
+		{
+			// 타이머를 못 만들었으면 ms 단위 timeout 으로 대신함
+			DWORD ms = (wait == FRAME_WAIT_INPUT) ? INFINITE : (DWORD)wait + 1;
+			if( ::MsgWaitForMultipleObjectsEx(count, handles, ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE) == WAIT_OBJECT_0 && wake )
+				pacer.markDirty(FRAME_SNAPSHOT);
+			continue;
+		}
+		if( wait > 0 )
+		{
+			LARGE_INTEGER due;
+			due.QuadPart = -(LONGLONG)(wait * 10000.0);   // 100ns 단위, 음수 = 지금부터
+			::SetWaitableTimer(timer, &due, 0, NULL, NULL, FALSE);
+			handles[count++] = timer;
+			if( ::MsgWaitForMultipleObjectsEx(count, handles, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE) == WAIT_OBJECT_0 && wake )
+				pacer.markDirty(FRAME_SNAPSHOT);
+			continue;
+		}
+
+		double timeDelta = (currTime - lastTime)*0.0007;
+		ptr_display((float)timeDelta);
+		pacer.endFrame(currTime);
+
+		lastTime = currTime;
+	}
+
+	if( timer )
+		::CloseHandle(timer);
+	if( raisedPeriod )
+		::timeEndPeriod(1);
+	return msg.wParam;
+}
 
 bool d3d::InitD3D(
 	HINSTANCE hInstance,
@@ -144,8 +222,22 @@ bool d3d::InitD3D(
 	return true;
 }
 
-int d3d::EnterMsgLoop( bool (*ptr_display)(float timeDelta) )
+double d3d::TimeMs()
+{
+	static LARGE_INTEGER freq = { 0 };
+	if( freq.QuadPart == 0 )
+		::QueryPerformanceFrequency(&freq);
+
+	LARGE_INTEGER now;
+	::QueryPerformanceCounter(&now);
+	return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+}
+
+int d3d::EnterMsgLoop( bool (*ptr_display)(float timeDelta), CFramePacer* pacer, HANDLE wake )
 {
+	if( pacer )
+		return PacedMsgLoop(ptr_display, *pacer, wake);
+
 	MSG msg;
 	::ZeroMemory(&msg, sizeof(MSG));
 
@@ -22,6 +22,8 @@
 #define EPSILON 0.001f
 #define INFINITY FLT_MAX
 
+class CFramePacer;
+
 
 namespace d3d
 {
@@ -35,8 +37,15 @@ namespace d3d
 		D3DDEVTYPE deviceType,     // [in] HAL or REF
 		IDirect3DDevice9** device);// [out]The created device.
 
+	// pacer 가 있으면 그 일정대로만 ptr_display 를 부르고 나머지 시간은 잠듦 (없으면 계속 돌림).
+	// wake (자동 리셋 이벤트) 가 신호되면 pacer 에 FRAME_SNAPSHOT 을 표시하고 깨어남.
 	int EnterMsgLoop( 
-		bool (*ptr_display)(float timeDelta));
+		bool (*ptr_display)(float timeDelta),
+		CFramePacer* pacer = 0,
+		HANDLE wake = 0);
+
+	// QueryPerformanceCounter 기준 ms
+	double TimeMs();
 
 	LRESULT CALLBACK WndProc(
 		HWND hwnd,
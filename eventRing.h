@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: eventRing.h
+//
+// Desc: 생산자 여럿, 소비자 하나용 lock-free 고정 크기 큐 (칸마다 순번을 둔 ring).
+//       여러 세션/스레드가 이벤트를 넣고 한 스레드가 꺼내 나눠 줄 때 사용 (simEvents.h).
+//       N 은 2 의 거듭제곱. 가득 차면 push 가 false 를 반환함 (이벤트를 버림).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __eventRingH__
+#define __eventRingH__
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t N>
+class CMpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+    CMpscRing() : m_head(0), m_tail(0)
+    {
+        for (size_t i = 0; i < N; i++) m_slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // 아무 스레드에서나. 칸의 순번이 pos 면 비어 있는 칸이고, tail 을 먼저 가져간 생산자가 씀.
+    bool push(const T& item)
+    {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[pos & (N - 1)];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = (std::ptrdiff_t)(seq - pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.item = item;
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;   // 소비자가 아직 안 꺼낸 칸까지 한 바퀴 돎
+            }
+            else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 소비자 스레드에서만. 순번이 pos + 1 이면 다 쓴 칸.
+    bool pop(T& item)
+    {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[pos & (N - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != pos + 1) return false;
+        item = slot.item;
+        slot.seq.store(pos + N, std::memory_order_release);
+        m_head.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> seq;
+        T                   item;
+    };
+
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+    alignas(64) Slot m_slots[N];
+};
+
+#endif // __eventRingH__
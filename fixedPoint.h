@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: fixedPoint.h
+//
+// Desc: Q8.24 고정소수점 수 (int32). 덧셈/곱셈/나눗셈/sqrt/삼각함수가 모두 정수 연산이라
+//       컴파일러, 최적화 옵션, CPU 가 달라도 같은 입력이면 비트까지 같은 결과가 나옴.
+//       범위 ±128, 해상도 2^-24 (테이블 좌표와 속도, 거리 제곱까지 들어감).
+//       곱셈은 int64 로 계산 후 반올림, 나눗셈은 0 쪽으로 버림.
+//       double 과의 변환은 상수와 비교용 (Fixed -> double 은 항상 정확).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __fixedPointH__
+#define __fixedPointH__
+
+#include <cmath>
+#include <cstdint>
+
+struct Fixed {
+    int32_t raw;
+
+    static const int FRAC_BITS = 24;
+    static const int32_t ONE = 1 << FRAC_BITS;
+
+    static constexpr Fixed fromRaw(int32_t r) { return Fixed{ r }; }
+    // 가장 가까운 값으로 반올림 (0.5 는 0 에서 먼 쪽), 범위 밖이면 끝값. 상수는 컴파일 때 계산됨.
+    static constexpr Fixed fromDouble(double d)
+    {
+        return d * ONE >= 2147483647.0 ? fromRaw(INT32_MAX)
+             : d * ONE <= -2147483648.0 ? fromRaw(INT32_MIN)
+             : fromRaw((int32_t)(d * ONE + (d >= 0 ? 0.5 : -0.5)));
+    }
+    constexpr double toDouble() const { return raw / (double)ONE; }
+
+    constexpr Fixed operator-() const { return fromRaw(-raw); }
+    constexpr Fixed operator+(Fixed b) const { return fromRaw(raw + b.raw); }
+    constexpr Fixed operator-(Fixed b) const { return fromRaw(raw - b.raw); }
+    constexpr Fixed operator*(Fixed b) const
+    {
+        return fromRaw((int32_t)(((int64_t)raw * b.raw + (ONE >> 1)) >> FRAC_BITS));
+    }
+    constexpr Fixed operator/(Fixed b) const
+    {
+        return fromRaw((int32_t)((int64_t)raw * ONE / b.raw));
+    }
+    Fixed& operator+=(Fixed b) { raw += b.raw; return *this; }
+    Fixed& operator-=(Fixed b) { raw -= b.raw; return *this; }
+
+    constexpr bool operator==(Fixed b) const { return raw == b.raw; }
+    constexpr bool operator!=(Fixed b) const { return raw != b.raw; }
+    constexpr bool operator<(Fixed b) const { return raw < b.raw; }
+    constexpr bool operator>(Fixed b) const { return raw > b.raw; }
+    constexpr bool operator<=(Fixed b) const { return raw <= b.raw; }
+    constexpr bool operator>=(Fixed b) const { return raw >= b.raw; }
+};
+
+// floor(sqrt(n)). double sqrt 는 처음 값으로만 쓰고 정수로 고쳐서 어느 기기에서나 같은 값.
+inline uint64_t fixedIsqrt(uint64_t n)
+{
+    uint64_t r = (uint64_t)std::sqrt((double)n);
+    while (r * r > n) r--;
+    while ((r + 1) * (r + 1) <= n) r++;
+    return r;
+}
+
+// 가장 가까운 정수로 반올림한 sqrt(n)
+inline uint64_t fixedRoundSqrt(uint64_t n)
+{
+    uint64_t r = fixedIsqrt(n);
+    return n - r * r > r ? r + 1 : r;
+}
+
+inline Fixed fixedSqrt(Fixed v)
+{
+    if (v.raw <= 0) return Fixed::fromRaw(0);
+    return Fixed::fromRaw((int32_t)fixedRoundSqrt((uint64_t)v.raw << Fixed::FRAC_BITS));
+}
+
+// sqrt(a² + b²). 제곱을 int64 로 하므로 a, b 가 커도 넘치지 않음.
+inline Fixed fixedHypot(Fixed a, Fixed b)
+{
+    uint64_t n = (uint64_t)((int64_t)a.raw * a.raw) + (uint64_t)((int64_t)b.raw * b.raw);
+    uint64_t r = fixedRoundSqrt(n);
+    return Fixed::fromRaw(r > (uint64_t)INT32_MAX ? INT32_MAX : (int32_t)r);
+}
+
+// 삼각함수는 CORDIC (Q2.30 각도, 시프트와 덧셈만). 오차는 1 LSB 이내.
+namespace fixedCordic {
+
+const int     STEPS = 30;
+const int     SHIFT = 30 - Fixed::FRAC_BITS;   // Q30 <-> Q24
+const int64_t PI = 3373259426LL;               // π (Q30)
+const int64_t HALF_PI = 1686629713LL;
+const int64_t GAIN = 652032874LL;              // 1 / Π sqrt(1 + 2^-2i) (Q30)
+// atan(2^-i) (Q30)
+const int64_t ATAN[STEPS] = {
+    843314857, 497837829, 263043837, 133525159, 67021687, 33543516, 16775851, 8388437,
+    4194283, 2097149, 1048576, 524288, 262144, 131072, 65536, 32768,
+    16384, 8192, 4096, 2048, 1024, 512, 256, 128, 64, 32, 16, 8, 4, 2,
+};
+
+inline Fixed toFixed(int64_t q30)
+{
+    return Fixed::fromRaw((int32_t)((q30 + (1 << (SHIFT - 1))) >> SHIFT));
+}
+
+} // namespace fixedCordic
+
+// 각도 (라디안) -> cos, sin
+inline void fixedSinCos(Fixed angle, Fixed& s, Fixed& c)
+{
+    using namespace fixedCordic;
+    int64_t t = (int64_t)angle.raw * (1 << SHIFT) % (2 * PI);
+    if (t > PI) t -= 2 * PI;
+    else if (t < -PI) t += 2 * PI;
+    // [-π/2, π/2] 로 옮긴 뒤 결과 부호를 뒤집음
+    bool flip = false;
+    if (t > HALF_PI) { t -= PI; flip = true; }
+    else if (t < -HALF_PI) { t += PI; flip = true; }
+
+    int64_t x = GAIN, y = 0;
+    for (int i = 0; i < STEPS; i++) {
+        int64_t dx = x >> i, dy = y >> i;
+        if (t >= 0) { x -= dy; y += dx; t -= ATAN[i]; }
+        else { x += dy; y -= dx; t += ATAN[i]; }
+    }
+    if (flip) { x = -x; y = -y; }
+    c = toFixed(x);
+    s = toFixed(y);
+}
+
+// atan2(y, x), 결과는 [-π, π]
+inline Fixed fixedAtan2(Fixed y, Fixed x)
+{
+    using namespace fixedCordic;
+    if (x.raw == 0 && y.raw == 0) return Fixed::fromRaw(0);
+
+    // 오른쪽 반평면으로 돌려 놓고 (π 회전) 벡터를 x 축으로 돌리는 각도를 더함.
+    // 정밀도를 위해 Q24 를 Q40 으로 (|값| < 2^47, CORDIC 이득을 곱해도 int64 안).
+    int64_t X = (int64_t)x.raw * 65536, Y = (int64_t)y.raw * 65536;
+    int64_t z = 0;
+    if (X < 0) {
+        X = -X;
+        Y = -Y;
+        z = y.raw >= 0 ? PI : -PI;
+    }
+    for (int i = 0; i < STEPS; i++) {
+        int64_t dx = X >> i, dy = Y >> i;
+        if (Y > 0) { X += dy; Y -= dx; z += ATAN[i]; }
+        else { X -= dy; Y += dx; z -= ATAN[i]; }
+    }
+    return toFixed(z);
+}
+
+#endif // __fixedPointH__
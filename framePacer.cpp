@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: framePacer.cpp
+//
+// Desc: 바뀐 것이 있을 때만 그리는 프레임 스케줄러
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "framePacer.h"
+
+CFramePacer::CFramePacer(double targetFps)
+    : m_next(0), m_awakeUntil(0), m_dirty(FRAME_VIEW), m_animating(false)   // 첫 프레임은 그림
+{
+    setTargetFps(targetFps);
+}
+
+void CFramePacer::setTargetFps(double fps)
+{
+    if (fps < 1) fps = 1;
+    m_interval = 1000.0 / fps;
+}
+
+void CFramePacer::keepAwake(double nowMs, double forMs)
+{
+    // 깨어 있는 동안 한 프레임은 꼭 확인하도록
+    if (forMs < m_interval) forMs = m_interval;
+    if (nowMs + forMs > m_awakeUntil) m_awakeUntil = nowMs + forMs;
+}
+
+double CFramePacer::waitMs(double nowMs) const
+{
+    if (!awake(nowMs)) return FRAME_WAIT_INPUT;
+    if (nowMs >= m_next) return 0;
+    return m_next - nowMs;
+}
+
+unsigned CFramePacer::endFrame(double nowMs)
+{
+    // 간격은 예정 시각 기준으로 쌓아서 어긋나지 않게 하고, 오래 쉬었다 오면 지금부터 다시 셈
+    m_next += m_interval;
+    if (m_next <= nowMs) m_next = nowMs + m_interval;
+
+    unsigned flags = m_dirty;
+    m_dirty = 0;
+    return flags;
+}
+
+// -----------------------------------------------------------------------------
+// 자체 점검
+// -----------------------------------------------------------------------------
+
+static int checkWait(FILE* out, const char* what, const CFramePacer& p, double nowMs, double expect)
+{
+    double got = p.waitMs(nowMs);
+    double d = got - expect;
+    if (d > -1e-6 && d < 1e-6) return 0;
+    fprintf(out, "pacer: %s: waitMs(%g) = %g, expected %g\n", what, nowMs, got, expect);
+    return 1;
+}
+
+int framePacerSelfCheck(FILE* out)
+{
+    int bad = 0;
+    CFramePacer p(50.0);   // 20ms 간격
+
+    // 첫 프레임은 바로 그리고, 그린 뒤 바뀐 것이 없으면 입력 대기
+    bad += checkWait(out, "first frame", p, 0, 0);
+    if (p.endFrame(0) != FRAME_VIEW) {
+        fprintf(out, "pacer: first endFrame did not return FRAME_VIEW\n");
+        bad++;
+    }
+    bad += checkWait(out, "idle", p, 5, FRAME_WAIT_INPUT);
+
+    // dirty 는 바로 깨우지만 간격보다 자주 그리지는 않음
+    p.markDirty(FRAME_AIM);
+    bad += checkWait(out, "dirty before interval", p, 5, 15);
+    bad += checkWait(out, "dirty at interval", p, 20, 0);
+    if (p.endFrame(21) != FRAME_AIM || p.dirty()) {
+        fprintf(out, "pacer: endFrame did not hand over and clear FRAME_AIM\n");
+        bad++;
+    }
+    bad += checkWait(out, "idle after dirty frame", p, 22, FRAME_WAIT_INPUT);
+
+    // 애니메이션 중 (공이 구르는 중) 에는 dirty 가 없어도 간격마다 깨어 있음.
+    // 간격은 예정 시각 (40) 기준으로 쌓임.
+    p.setAnimating(true);
+    bad += checkWait(out, "animating", p, 30, 10);
+    bad += checkWait(out, "animating at interval", p, 40, 0);
+    p.endFrame(41);
+    bad += checkWait(out, "animating next", p, 45, 15);
+    p.setAnimating(false);
+    bad += checkWait(out, "animation stopped", p, 45, FRAME_WAIT_INPUT);
+
+    // 입력 뒤에는 forMs 동안 깨어 있고, 짧게 줘도 한 간격은 깨어 있음
+    p.keepAwake(50, 100);
+    bad += checkWait(out, "keepAwake", p, 100, 0);
+    bad += checkWait(out, "keepAwake expired", p, 151, FRAME_WAIT_INPUT);
+    p.keepAwake(200, 1);
+    bad += checkWait(out, "keepAwake minimum", p, 215, 0);
+    bad += checkWait(out, "keepAwake minimum expired", p, 221, FRAME_WAIT_INPUT);
+    p.keepAwake(300, 100);
+    p.keepAwake(310, 10);   // 더 짧은 요청은 앞의 것을 줄이지 않음
+    bad += checkWait(out, "keepAwake not shortened", p, 390, 0);
+
+    // 오래 쉬었다 오면 밀린 프레임을 몰아서 그리지 않고 지금부터 다시 셈
+    p.endFrame(1000);
+    p.markDirty(FRAME_MOTION);
+    bad += checkWait(out, "after long idle", p, 1005, 15);
+
+    // fps 는 1 아래로 내려가지 않음
+    p.setTargetFps(0);
+    if (p.intervalMs() != 1000) {
+        fprintf(out, "pacer: setTargetFps(0) interval %g, expected 1000\n", p.intervalMs());
+        bad++;
+    }
+    return bad;
+}
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: framePacer.h
+//
+// Desc: 바뀐 것이 있을 때만 그리는 프레임 스케줄러 (플랫폼 무관, 시각은 ms 로 받음).
+//       dirty (공 이동, 조준, 점수 ...) 가 있거나 애니메이션 중이면 target 간격으로 그리고,
+//       아무것도 없으면 waitMs() 가 FRAME_WAIT_INPUT 을 돌려줘서 입력이 올 때까지 잠들게 함.
+//       호출하는 쪽 (EnterMsgLoop) 이 실제 대기와 시계를 맡음.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __framePacerH__
+#define __framePacerH__
+
+#include <cstdio>
+
+enum FrameDirty {
+    FRAME_MOTION = 1,   // 공 위치
+    FRAME_AIM = 2,      // 파란공, 조준선
+    FRAME_SCORE = 4,    // 점수, 턴, 승자 표시
+    FRAME_VIEW = 8,     // 창 다시 그리기, 와이어프레임 전환 등
+    FRAME_SNAPSHOT = 16,   // 시뮬레이션 스레드가 새 상태를 내보냄 (무엇이 바뀌었는지는 그리는 쪽이 봄)
+};
+
+const double FRAME_WAIT_INPUT = -1;   // 입력이 올 때까지 무한히 대기
+
+class CFramePacer {
+public:
+    explicit CFramePacer(double targetFps = 60.0);
+
+    void setTargetFps(double fps);
+    double intervalMs() const { return m_interval; }
+
+    void markDirty(unsigned flags) { m_dirty |= flags; }
+    // 공이 움직이거나 AI 가 생각하는 동안: dirty 가 없어도 target 간격으로 깨어나서 상태를 확인
+    void setAnimating(bool on) { m_animating = on; }
+    // 입력을 보낸 뒤 결과가 나올 때까지 (다른 스레드에서 적용됨) 잠깐 깨어 있음
+    void keepAwake(double nowMs, double forMs);
+
+    // 다음 프레임까지 기다릴 ms. 0 이면 지금 그림, FRAME_WAIT_INPUT 이면 입력 대기.
+    double waitMs(double nowMs) const;
+    bool   due(double nowMs) const { return waitMs(nowMs) == 0; }
+
+    // 이번 프레임에 그릴 것. 0 이면 상태만 확인하고 그리지 않아도 됨.
+    unsigned dirty() const { return m_dirty; }
+    // 프레임 끝: dirty 를 지우고 다음 프레임 시각을 정함. 지운 dirty 를 돌려줌.
+    unsigned endFrame(double nowMs);
+
+private:
+    bool awake(double nowMs) const { return m_dirty || m_animating || nowMs < m_awakeUntil; }
+
+    double   m_interval;
+    double   m_next;         // 다음 프레임을 그릴 수 있는 가장 이른 시각
+    double   m_awakeUntil;
+    unsigned m_dirty;
+    bool     m_animating;
+};
+
+// dirty / animating / keepAwake / 간격 계산을 정해 둔 시각들로 점검 (simTool pacer).
+// 틀린 항목을 out 에 쓰고 그 수를 돌려줌.
+int framePacerSelfCheck(FILE* out);
+
+#endif // __framePacerH__
@@ -0,0 +1,509 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: gameSession.cpp
+//
+// Desc: 게임 한 판의 상태와 규칙
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "gameSession.h"
+#include "billiardSimCore.h"
+#include "trace.h"
+#include "allocTrack.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+
+struct CGameSession::AITask {
+    std::atomic<bool> done;
+    AIDecision        result;
+};
+
+struct CGameSession::SaveTask {
+    std::atomic<bool> done;
+};
+
+SessionAI::SessionAI()
+    : replayPath(REPLAY_FILE), budget(QTABLE_UNBOUNDED), learning(true), saveEachTurn(false),
+      policy(NULL), mlp(NULL), planner(NULL), aim(NULL), executor(NULL), thinkBudgetMs(0)
+{
+    lastState = State();
+    lastSample = PolicySample();
+}
+
+CGameSession::CGameSession(unsigned seed)
+    : m_deterministic(false), m_events(NULL), m_eventSource(0), m_winScore(1), m_rng(seed ? seed : (unsigned)time(NULL)), m_saveDirty(false)
+{
+    reset();
+}
+
+CGameSession::~CGameSession()
+{
+    waitBackground();   // 작업이 세션 멤버를 참조하므로
+}
+
+void CGameSession::waitBackground()
+{
+    while ((m_aiTask && !m_aiTask->done) || (m_saveTask && !m_saveTask->done))
+        std::this_thread::yield();
+}
+
+void CGameSession::reset()
+{
+    simReset(m_world);
+    simcore::reset(m_fixed);
+    m_targetX = m_targetZ = 0;
+    m_isTurnStarted = false;
+    m_isWhiteTurn = 1;
+    m_whiteScore = 0;
+    m_yellowScore = 0;
+    m_winner = 0;
+    m_isInitBlue = false;
+    m_turnCount = 0;
+    waitBackground();
+    m_aiTask.reset();
+}
+
+void CGameSession::snapshot(GameSnapshot& out) const
+{
+    for (int i = 0; i < SIM_BALLS; i++) out.ball[i] = m_world.ball[i];
+    out.targetX = m_targetX;
+    out.targetZ = m_targetZ;
+    out.isWhiteTurn = m_isWhiteTurn;
+    out.isTurnStarted = m_isTurnStarted;
+    out.isThinking = m_aiTask != NULL;
+    out.whiteScore = m_whiteScore;
+    out.yellowScore = m_yellowScore;
+    out.winner = m_winner;
+    out.turnCount = m_turnCount;
+}
+
+void CGameSession::saveState(SimGame& out) const
+{
+    out.world = m_world;
+    out.isWhiteTurn = (signed char)m_isWhiteTurn;
+    out.winner = (signed char)m_winner;
+    out.winScore = (short)m_winScore;
+    out.whiteScore = (short)m_whiteScore;
+    out.yellowScore = (short)m_yellowScore;
+}
+
+void CGameSession::restoreState(const SimGame& in)
+{
+    m_world = in.world;
+    simTouch(m_world);
+    simcore::convert(m_world, m_fixed);
+    m_isWhiteTurn = in.isWhiteTurn;
+    m_winner = in.winner;
+    m_winScore = in.winScore;
+    m_whiteScore = in.whiteScore;
+    m_yellowScore = in.yellowScore;
+    m_isTurnStarted = false;
+}
+
+void CGameSession::setDeterministic(bool on)
+{
+    if (on && !m_deterministic) simcore::convert(m_world, m_fixed);
+    m_deterministic = on;
+}
+
+void CGameSession::physStep(float dt)
+{
+    TRACE_SCOPE("physStep");   // ballUpdate + hitBy 한 묶음 (공/쌍마다 재면 재는 비용이 더 큼)
+    ALLOC_FORBID("physics");
+    unsigned awake = m_events ? simAwakeMask(m_world) : 0;
+    if (!m_deterministic) {
+        simStep(m_world, dt);
+    }
+    else {
+        // hit 와 접촉은 점수 처리에서 m_world 쪽을 지우므로 그쪽을 따름
+        simcore::copyContacts(m_world, m_fixed);
+        simcore::step(m_fixed, Fixed::fromDouble(dt));
+        simcore::convert(m_fixed, m_world);
+    }
+    if (m_events) emitStepEvents(awake);
+}
+
+void CGameSession::physFire(int ball, float x, float z)
+{
+    if (m_events) {
+        const SimBall& b = m_world.ball[ball];
+        emit(EVENT_SHOT_FIRED, ball, -1, sqrtf((x - b.x) * (x - b.x) + (z - b.z) * (z - b.z)));
+    }
+    if (!m_deterministic) {
+        simFire(m_world, ball, x, z);
+        return;
+    }
+    simcore::copyContacts(m_world, m_fixed);
+    simcore::fire(m_fixed, ball, Fixed::fromDouble(x), Fixed::fromDouble(z));
+    simcore::convert(m_fixed, m_world);
+}
+
+bool CGameSession::physStopped() const
+{
+    return m_deterministic ? simcore::allStopped(m_fixed) : simAllStopped(m_world);
+}
+
+void CGameSession::emit(int type, int ball, int other, float value)
+{
+    SimEvent e;
+    e.type = (unsigned char)type;
+    e.ball = (signed char)ball;
+    e.other = (signed char)other;
+    e.player = (signed char)m_isWhiteTurn;
+    e.step = m_world.step;
+    e.source = (unsigned short)m_eventSource;
+    e.turn = m_turnCount;
+    e.value = value;
+    m_events->publish(e);
+}
+
+// 방금 step 의 쿠션, 접촉 시작, 멈춘 공. 물리에서 벽이 공끼리 충돌보다 먼저이므로 그 순서로.
+void CGameSession::emitStepEvents(unsigned awakeBefore)
+{
+    const SimWorld& w = m_world;
+    for (int i = 0; i < SIM_BALLS; i++) {
+        const SimBall& b = w.ball[i];
+        for (int k = 0; k < w.cushionHits[i]; k++)
+            emit(EVENT_CUSHION, i, -1, sqrtf(b.vx * b.vx + b.vz * b.vz));
+    }
+    if (w.began) {
+        for (int i = 0; i < SIM_BALLS; i++) {
+            for (int j = i + 1; j < SIM_BALLS; j++) {
+                int p = simPair(i, j);
+                if ((w.began >> p) & 1) emit(EVENT_BALL_CONTACT, i, j, w.impact[p]);
+            }
+        }
+    }
+    unsigned stopped = awakeBefore & ~simAwakeMask(w);
+    for (int i = 0; i < SIM_BALLS; i++) {
+        if ((stopped >> i) & 1) emit(EVENT_BALL_STOPPED, i, -1, 0);
+    }
+}
+
+bool CGameSession::step(float dt)
+{
+    // AI 조준이 끝났으면 이번 프레임에 발사
+    if (m_aiTask && m_aiTask->done) {
+        applyAIShot(m_aiTask->result);
+        m_aiTask.reset();
+        m_isTurnStarted = true;
+    }
+    // 저장 중이라 건너뛴 저장이 있으면 앞의 저장이 끝난 뒤에
+    if (m_saveDirty && m_saveTask->done) saveLearningAsync();
+
+    physStep(dt);
+
+    // white Turn 일 때 파란공 위치 초기화 (턴 중에는 isInitBlue 유지, updateScore 에서 false 로)
+    if (m_isWhiteTurn == 1 && !m_isTurnStarted && !m_isInitBlue) {
+        m_targetX = m_targetZ = 0;
+        m_isInitBlue = true;
+    }
+
+    // 모든 공이 멈췄으면 점수 계산 (한 번만)
+    if (physStopped() && m_isTurnStarted) {
+        updateScore();
+        m_isTurnStarted = false;
+        m_turnCount++;
+        return true;
+    }
+    return false;
+}
+
+void CGameSession::fire()
+{
+    if (m_aiTask) return;   // 이미 조준 중
+
+    if (m_isWhiteTurn == -1 && m_ai.executor) {
+        // 조준은 executor 에서. 턴 시작 (isTurnStarted) 은 발사할 때.
+        std::shared_ptr<AITask> task = std::make_shared<AITask>();
+        task->done = false;
+        SimWorld world = m_world;
+        float tx = m_targetX, tz = m_targetZ;
+        unsigned seed = m_rng();
+        m_aiTask = task;
+        m_ai.executor->submit([this, task, world, tx, tz, seed] {
+            std::mt19937 rng(seed);
+            task->result = decideAIShot(world, tx, tz, rng);
+            task->done = true;
+        });
+        return;
+    }
+
+    if (m_isWhiteTurn == 1)
+        physFire(BALL_WHITE, m_targetX, m_targetZ);
+    else if (m_isWhiteTurn == -1)
+        AIFireYellowBall();
+
+    // 처음으로 눌렸을때 -> 게임 시작이니까 상태 변환
+    m_isTurnStarted = true;
+}
+
+void CGameSession::fireAt(float x, float z)
+{
+    setTarget(x, z);
+    physFire(m_isWhiteTurn == 1 ? BALL_WHITE : BALL_YELLOW, x, z);
+    m_isTurnStarted = true;
+}
+
+/*
+공별로 점수를 계산하는 함수. 흰 공(player 1)과 노란 공(player 2)만을 대상으로 고려.
+Rule: 1. 상대방의 공을 건드렸거나, 빨간 공을 하나도 못 쳤을 경우 -1점 2. NOT 1이면서 빨간 공을 한개만 친 경우 0점. 3. NOT 1이면서 빨간 공을 두개 모두 친 경우 +1점.
+total_score>0일 시 턴 유지, 그렇지 않은 경우 턴 토글.
+*/
+int CGameSession::getScore() const
+{
+    return simTurnScore(m_world, m_isWhiteTurn);
+}
+
+void CGameSession::updateScore()
+{
+    int score = getScore();
+    if (m_events) {
+        int ball = m_isWhiteTurn == 1 ? BALL_WHITE : BALL_YELLOW;
+        emit(EVENT_TURN_END, ball, -1, (float)score);
+        if (score != 0)
+            emit(EVENT_SCORE_CHANGE, ball, -1, (float)((m_isWhiteTurn == 1 ? m_whiteScore : m_yellowScore) + score));
+    }
+
+    switch (m_isWhiteTurn) {
+        // 하얀공 턴
+    case (1):
+        if (score == 1) {
+            m_whiteScore += 1;
+        }
+        else if (score == -1) {
+            m_whiteScore += -1;
+            m_isWhiteTurn = -m_isWhiteTurn; // turn change
+        }
+        else if (score == 0) {
+            m_isWhiteTurn = -m_isWhiteTurn; // turn change
+        }
+        break;
+        // 노란공 턴
+    case (-1):
+        if (score == 1) {
+            m_yellowScore += 1;
+        }
+        else if (score == -1) {
+            m_yellowScore += -1;
+            m_isWhiteTurn = -m_isWhiteTurn; // turn change
+        }
+        else if (score == 0) {
+            m_isWhiteTurn = -m_isWhiteTurn; // turn change
+        }
+        break;
+    default:
+        break;
+    }
+
+    simClearHits(m_world);
+
+    if (m_isWhiteTurn == -1) { // 노란공일떄 학습 업데이트
+        OnAITurnEnd();
+    }
+
+    // 승리 판별하기.
+    if (m_whiteScore >= m_winScore) {
+        m_winner = 3;
+    }
+    else if (m_yellowScore >= m_winScore) {
+        m_winner = 2;
+    }
+    m_isInitBlue = false;
+}
+
+void CGameSession::OnAITurnEnd()
+{
+    ALLOC_SCOPE("learning");   // 테이블이 커지고 저장 작업을 넘김 (턴에 한 번)
+    if (m_ai.learning) {
+        int reward = simAIPoint(m_world);
+        UpdateQTable(m_ai.qTable, m_ai.lastState, (float)reward, m_ai.budget);
+        if (!m_ai.shardPath.empty())
+            UpdateQTable(m_ai.shardTable, m_ai.lastState, (float)reward, m_ai.budget);
+        if (m_ai.saveEachTurn) {
+            if (m_ai.executor) saveLearningAsync();
+            else saveLearning();
+        }
+
+        m_ai.lastSample.reward = (float)reward;
+        if (!m_ai.replayPath.empty())
+            AppendReplaySample(m_ai.lastSample, m_ai.replayPath.c_str());   // MLP 학습 데이터
+    }
+
+    // 다음 턴 준비: hit 초기화
+    m_world.hit[BALL_YELLOW] = 0;
+}
+
+void CGameSession::saveLearning()
+{
+    if (!m_ai.shardPath.empty()) {
+        SortQTable(m_ai.shardTable);   // merge 가 정렬된 shard 를 요구함
+        SaveQTable(m_ai.shardTable, m_ai.shardPath.c_str());
+    }
+    else {
+        SaveQTable(m_ai.qTable);
+    }
+}
+
+void CGameSession::saveLearningAsync()
+{
+    // 저장 중이면 이번 것은 건너뛰고 다음 턴에 최신 테이블로 저장
+    if (m_saveTask && !m_saveTask->done) {
+        m_saveDirty = true;
+        return;
+    }
+    m_saveDirty = false;
+
+    // 학습은 이 스레드에서 계속되므로 지금 테이블을 복사해서 넘김
+    std::shared_ptr<SaveTask> task = std::make_shared<SaveTask>();
+    task->done = false;
+    std::shared_ptr<std::vector<QEntry> > table = std::make_shared<std::vector<QEntry> >(
+        m_ai.shardPath.empty() ? m_ai.qTable : m_ai.shardTable);
+    std::string path = m_ai.shardPath.empty() ? std::string(QTABLE_FILE) : m_ai.shardPath;
+    bool sort = !m_ai.shardPath.empty();
+    m_saveTask = task;
+    m_ai.executor->submit([task, table, path, sort] {
+        if (sort) SortQTable(*table);   // merge 가 정렬된 shard 를 요구함
+        SaveQTable(*table, path.c_str());
+        task->done = true;
+    });
+}
+
+// 노란공 기준 상대 좌표 (bin)
+static State getCurrentState(const SimWorld& w, float targetX, float targetZ)
+{
+    const SimBall* b = w.ball;
+    const SimBall& yellow = b[BALL_YELLOW];
+
+    State s;
+    s.dx1 = bin(b[BALL_RED1].x - yellow.x);
+    s.dz1 = bin(b[BALL_RED1].z - yellow.z);
+    s.dx2 = bin(b[BALL_RED2].x - yellow.x);
+    s.dz2 = bin(b[BALL_RED2].z - yellow.z);
+    s.dxw = bin(b[BALL_WHITE].x - yellow.x);
+    s.dzw = bin(b[BALL_WHITE].z - yellow.z);
+    s.tx = bin(targetX - yellow.x);
+    s.tz = bin(targetZ - yellow.z);
+    return s;
+}
+
+// getCurrentState 와 같은 값이지만 bin 하지 않은 연속 좌표 {dx1, dz1, dx2, dz2, dxw, dzw}
+static void getCurrentInputs(const SimWorld& w, float in[6])
+{
+    const SimBall* b = w.ball;
+    const SimBall& yellow = b[BALL_YELLOW];
+    in[0] = b[BALL_RED1].x - yellow.x;
+    in[1] = b[BALL_RED1].z - yellow.z;
+    in[2] = b[BALL_RED2].x - yellow.x;
+    in[3] = b[BALL_RED2].z - yellow.z;
+    in[4] = b[BALL_WHITE].x - yellow.x;
+    in[5] = b[BALL_WHITE].z - yellow.z;
+}
+
+// ai 발사 로직
+void CGameSession::AIFireYellowBall()
+{
+    TRACE_SCOPE("AIFireYellowBall");
+    applyAIShot(decideAIShot(m_world, m_targetX, m_targetZ, m_rng));
+}
+
+// 조준만 고름. executor 에서 불릴 수 있으므로 세션의 공/조준점 대신 인자를 씀.
+// (qTable 은 학습이 턴 끝에만 일어나고 그 전에 조준이 끝나므로 같이 읽어도 됨)
+AIDecision CGameSession::decideAIShot(const SimWorld& world, float targetX, float targetZ, std::mt19937& rng)
+{
+    ALLOC_FORBID("ai select");
+    // 현재 게임판 상태
+    State baseState = getCurrentState(world, targetX, targetZ);
+    std::vector<QEntry>& qTable = m_ai.qTable;
+    const SimBall& yellow = world.ball[BALL_YELLOW];
+
+    float tx = 0, tz = 0;
+    int ptx, ptz;
+    int qIndex = -1;
+    float inputs[6];
+    getCurrentInputs(world, inputs);
+
+    if (m_ai.planner || m_ai.aim) {
+        // 남은 느린 움직임까지 멈춘 배치에서 탐색. 플래너가 이전 턴에 득점 뒤 이어 칠 배치로
+        // 평가한 것도 이 배치라서 캐시에서 그대로 찾을 수 있음.
+        SimWorld still = world;
+        simSettle(still);
+        simClearHits(still);
+        if (m_ai.planner) {
+            PlannedShot shot = m_ai.planner->plan(still, -1, m_ai.thinkBudgetMs);
+            tx = shot.targetX;
+            tz = shot.targetZ;
+        }
+        else {
+            AimShot shot = m_ai.aim->optimize(still, -1, rng, m_ai.thinkBudgetMs);
+            tx = shot.targetX;
+            tz = shot.targetZ;
+        }
+    }
+    else if (m_ai.mlp && m_ai.mlp->isLoaded() && (!m_ai.learning || rng() % 100 < 80)) {
+        // MLP: 조준 후보 격자 중 예상 보상이 가장 높은 것 (학습 중이면 20% 는 탐색)
+        float ax, az;
+        m_ai.mlp->bestAim(inputs, ax, az);
+        tx = yellow.x + ax;
+        tz = yellow.z + az;
+    }
+    else if (!m_ai.learning && m_ai.policy && m_ai.policy->lookup(baseState.dx1, baseState.dx2, ptx, ptz)) {
+        // 학습 끔: 정책표에서 바로 조준 (탐색 없음)
+        tx = ptx * 0.5f;  // 다시 실제좌표로 환산
+        tz = ptz * 0.5f;
+    }
+    else {
+        // 1️⃣ 학습된 상태 중 평균보상이 가장 높은 조준을 찾기
+        auto best = std::max_element(qTable.begin(), qTable.end(),
+            [&](const QEntry& a, const QEntry& b) {
+                // 현재 환경이 유사한 상태만 비교
+                bool similarA = (abs(a.state.dx1 - baseState.dx1) <= 1 &&
+                    abs(a.state.dx2 - baseState.dx2) <= 1);
+                bool similarB = (abs(b.state.dx1 - baseState.dx1) <= 1 &&
+                    abs(b.state.dx2 - baseState.dx2) <= 1);
+                if (!similarA && !similarB) return false;
+                if (similarA && !similarB) return false;
+                if (!similarA && similarB) return true;
+                return a.avgReward < b.avgReward;
+            });
+
+        // 2️⃣ 80% 확률로 best, 20% 확률로 탐색(random)
+        if (best != qTable.end() && rng() % 100 < 80) {
+            tx = best->state.tx * 0.5f;  // 다시 실제좌표로 환산
+            tz = best->state.tz * 0.5f;
+            qIndex = (int)(best - qTable.begin());   // LRU 갱신은 applyAIShot 에서 (저장 복사와 같은 스레드)
+        }
+        else {
+            tx = ((rng() % 1200) / 100.0f - 6.0f);
+            tz = ((rng() % 800) / 100.0f - 4.0f);
+        }
+    }
+
+    // 현재 상태 저장 (턴 종료 후 보상 업데이트용)
+    AIDecision d;
+    d.tx = tx;
+    d.tz = tz;
+    d.state = baseState;
+    d.state.tx = bin(tx - yellow.x);
+    d.state.tz = bin(tz - yellow.z);
+    for (int i = 0; i < 6; i++) d.sample.in[i] = inputs[i];
+    d.sample.in[6] = tx - yellow.x;
+    d.sample.in[7] = tz - yellow.z;
+    d.sample.reward = 0;
+    d.qIndex = qIndex;
+    return d;
+}
+
+// 파란공 조준점 이동 후 노란공 발사
+void CGameSession::applyAIShot(const AIDecision& d)
+{
+    setTarget(d.tx, d.tz);
+    physFire(BALL_YELLOW, d.tx, d.tz);
+    m_ai.lastState = d.state;
+    m_ai.lastSample = d.sample;
+    if (d.qIndex >= 0 && d.qIndex < (int)m_ai.qTable.size())
+        TouchQEntry(m_ai.qTable[d.qIndex]);   // LRU 용
+}
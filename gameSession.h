@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: gameSession.h
+//
+// Desc: 게임 한 판의 상태를 모두 가진 객체 (공 4개, 파란 조준공, 턴, 점수, 승자, 노란공 AI).
+//       전역 변수를 쓰지 않으므로 한 프로세스에서 여러 판을 여러 스레드에 나눠 돌릴 수 있음.
+//       (세션 하나는 한 스레드에서만 만짐. 정책표/MLP/플래너처럼 읽기만 하는 것은 세션끼리 공유)
+//       화면 없는 물리는 billiardSim, 화면 (virtualLego.cpp) 은 world() 를 그리기만 함.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __gameSessionH__
+#define __gameSessionH__
+
+#include "billiardSim.h"
+#include "fixedPoint.h"
+#include "qTable.h"
+#include "policyTable.h"
+#include "simEvents.h"
+#include "neuralPolicy.h"
+#include "shotPlanner.h"
+#include "aimOptimizer.h"
+#include "threadPool.h"
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// 세션마다 하나씩 두는 노란공 AI
+struct SessionAI {
+    std::vector<QEntry> qTable;       // 이 세션이 조준을 고르고 갱신하는 테이블
+    std::vector<QEntry> shardTable;   // shardPath 가 있으면 이 세션이 배운 경험만 따로
+    std::string  shardPath;
+    std::string  replayPath;          // 비어 있으면 replay 로그 안 남김
+    QTableBudget budget;
+    bool         learning;            // false 면 갱신/저장 없이 정책표로만 둠
+    bool         saveEachTurn;        // 턴마다 파일로 저장 (GUI 는 원래 이렇게 했음)
+
+    // 여러 세션이 같이 쓰는 읽기 전용 정책 (NULL 이면 안 씀)
+    const CPolicyTable*  policy;
+    const CNeuralPolicy* mlp;
+    CShotPlanner*        planner;     // plan() 은 여러 스레드에서 동시에 불러도 됨
+    CAimOptimizer*       aim;         // planner 가 없을 때 이번 샷만 최적화 (optimize() 도 동시 호출 가능)
+
+    // NULL 이 아니면 AI 조준과 턴마다 저장을 이 풀에서 돌리고 결과는 다음 step() 에서 적용.
+    // NULL 이면 예전처럼 fire() / updateScore() 안에서 바로 처리.
+    CThreadPool*         executor;
+    double               thinkBudgetMs;   // 플래너 / CEM 조준이 한 번에 쓸 시간 (0 이면 각자 설정값)
+
+    // 마지막 AI 샷 (턴 종료 후 보상 업데이트용)
+    State        lastState;
+    PolicySample lastSample;
+
+    SessionAI();
+};
+
+// 화면이 그리는 데 필요한 상태만 복사한 것 (다른 스레드로 넘기는 용도)
+struct GameSnapshot {
+    SimBall ball[SIM_BALLS];
+    float   targetX, targetZ;
+    int     isWhiteTurn;
+    bool    isTurnStarted;
+    bool    isThinking;  // AI 가 조준을 고르는 중
+    int     whiteScore, yellowScore;
+    int     winner;
+    int     turnCount;   // 끝난 턴 수 (바뀌면 턴이 끝난 것)
+};
+
+// AI 가 고른 샷 (조준점 + 학습용 상태)
+struct AIDecision {
+    float        tx, tz;
+    State        state;
+    PolicySample sample;
+    int          qIndex;   // 고른 qTable 엔트리 (없으면 -1). lastUse 는 applyAIShot 에서 갱신.
+};
+
+class CGameSession {
+public:
+    explicit CGameSession(unsigned seed = 0);
+    ~CGameSession();
+
+    void reset();   // 시작 배치, 점수 0, 하얀공 턴
+
+    // 한 프레임 분량의 물리와 턴 종료 처리. 이번 호출에서 턴이 끝났으면 true.
+    bool step(float dt);
+    // VK_SPACE: 하얀공 턴이면 파란공 쪽으로, 노란공 턴이면 AI 가 조준해서 발사.
+    // executor 가 있으면 노란공은 조준만 시작하고 (isThinking), 다 고르면 step() 에서 발사.
+    void fire();
+    // 지금 턴인 공을 (x, z) 쪽으로 발사 (AI 를 거치지 않음. 사람/외부 봇 용)
+    void fireAt(float x, float z);
+
+    // 파란공 (하얀공 턴의 조준점)
+    void  setTarget(float x, float z) { m_targetX = x; m_targetZ = z; }
+    float getTargetX() const { return m_targetX; }
+    float getTargetZ() const { return m_targetZ; }
+
+    int  getScore() const;   // 지금 턴인 공 기준 (CSphere::getScore)
+    void updateScore();      // 모든 공이 멈췄을 때 점수/턴 갱신
+    void OnAITurnEnd();      // 노란공 학습 업데이트
+    void AIFireYellowBall();
+    void saveLearning();
+    void waitBackground();   // 돌고 있는 AI 조준/저장 작업이 끝날 때까지 기다림
+
+    const SimWorld& world() const { return m_world; }
+    SimWorld&       world() { return m_world; }
+    SessionAI&      ai() { return m_ai; }
+
+    int  isWhiteTurn() const { return m_isWhiteTurn; }
+    bool isTurnStarted() const { return m_isTurnStarted; }
+    bool isThinking() const { return m_aiTask != NULL; }
+    int  whiteScore() const { return m_whiteScore; }
+    int  yellowScore() const { return m_yellowScore; }
+    int  winner() const { return m_winner; }   // 0: 진행 중, 2: yellow, 3: white
+    void setWinScore(int score) { m_winScore = score; }
+    int  turnCount() const { return m_turnCount; }
+    void snapshot(GameSnapshot& out) const;
+
+    // 공/턴/점수를 POD 하나로 저장, 복원 (탐색에서 가지 치기, 되돌리기). 조준점과 AI 상태는 그대로.
+    // 복원하면 턴은 시작 전 상태가 됨.
+    void saveState(SimGame& out) const;
+    void restoreState(const SimGame& in);
+
+    // 결정적 모드: 물리를 Fixed (정수 연산) 로 돌리고 world() 는 그 결과를 float 로 옮긴 것.
+    // 같은 샷들을 같은 dt (SIM_TIME_STEP) 로 돌리면 어느 빌드/기기에서나 궤적, hit, 점수가 같음.
+    // 켜는 순간의 배치에서 이어서 진행.
+    void setDeterministic(bool on);
+    bool isDeterministic() const { return m_deterministic; }
+
+    // 접촉/쿠션/멈춤/발사/턴 끝/점수 이벤트를 bus 로 (NULL 이면 안 보냄). source 는 SimEvent::source.
+    // bus 는 여러 세션이 같이 써도 됨.
+    void setEventBus(CEventBus* bus, int source = 0) { m_events = bus; m_eventSource = source; }
+
+private:
+    struct AITask;     // executor 에서 도는 조준 작업
+    struct SaveTask;   // executor 에서 도는 저장 작업
+
+    // 다른 스레드에서 불려도 되도록 세션 상태 대신 world/조준점을 받음
+    AIDecision decideAIShot(const SimWorld& world, float targetX, float targetZ, std::mt19937& rng);
+    void       applyAIShot(const AIDecision& d);
+    void       saveLearningAsync();
+
+    // 물리는 모두 여기를 거침 (결정적 모드면 m_fixed 로 계산해서 m_world 에 옮김)
+    void physStep(float dt);
+    void physFire(int ball, float x, float z);
+    bool physStopped() const;
+    void emit(int type, int ball, int other, float value);
+    void emitStepEvents(unsigned awakeBefore);
+
+    SimWorld  m_world;
+    bool      m_deterministic;
+    SimWorldT<Fixed> m_fixed;   // 결정적 모드의 실제 물리 상태
+    CEventBus* m_events;
+    int        m_eventSource;
+    float     m_targetX, m_targetZ;
+    bool      m_isTurnStarted;
+    int       m_isWhiteTurn;   // 하얀공부터 시작
+    int       m_whiteScore;
+    int       m_yellowScore;
+    int       m_winScore;
+    int       m_winner;
+    bool      m_isInitBlue;
+    int       m_turnCount;
+
+    SessionAI    m_ai;
+    std::mt19937 m_rng;   // rand() 대신 세션마다 따로 (스레드끼리 안 섞이도록)
+
+    std::shared_ptr<AITask>   m_aiTask;     // 조준 중이면 NULL 아님
+    std::shared_ptr<SaveTask> m_saveTask;   // 마지막으로 시작한 저장
+    bool                      m_saveDirty;  // 저장 중이라 건너뛴 저장이 있음
+};
+
+#endif // __gameSessionH__
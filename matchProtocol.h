@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: matchProtocol.h
+//
+// Desc: matchServer 와 클라이언트 사이의 바이너리 프로토콜.
+//       메시지 = MsgHeader (8 byte) + 본문 (header.size byte). 모두 little-endian, 4 byte 정렬.
+//       요청 하나에 응답 하나 (MSG_STATE 또는 MSG_ERROR) 가 같은 session 번호로 돌아옴.
+//
+//       MSG_CREATE  (MsgCreate)  새 판. 응답의 header.session 이 이후 요청에 쓸 번호.
+//       MSG_SHOT    (MsgShot)    사람 차례에 (targetX, targetZ) 로 발사. 끝나면 이어지는 AI 차례도 서버가 침.
+//       MSG_PLAY    (MsgPlay)    AI 차례만 최대 maxShots 번 진행 (AI 끼리 두는 판)
+//       MSG_QUERY   (본문 없음)   현재 상태
+//       MSG_CLOSE   (본문 없음)   판 정리
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __matchProtocolH__
+#define __matchProtocolH__
+
+#include <stdint.h>
+
+#define MATCH_SOCKET_PATH "/tmp/pocketball.sock"
+
+const int MATCH_MAX_PAYLOAD = 256;
+const int MATCH_AUTO_SHOTS = 64;   // MSG_SHOT 뒤에 AI 가 이어서 칠 수 있는 최대 샷 수
+
+enum MatchMsgType {
+    MSG_CREATE = 1,
+    MSG_SHOT = 2,
+    MSG_PLAY = 3,
+    MSG_QUERY = 4,
+    MSG_CLOSE = 5,
+
+    MSG_STATE = 101,
+    MSG_ERROR = 102,
+};
+
+enum MatchError {
+    MATCH_ERR_BAD_MESSAGE = 1,
+    MATCH_ERR_NO_SESSION = 2,
+    MATCH_ERR_NOT_YOUR_TURN = 3,   // AI 차례에 MSG_SHOT
+    MATCH_ERR_GAME_OVER = 4,
+    MATCH_ERR_FULL = 5,
+};
+
+// MsgCreate.flags
+enum {
+    MATCH_WHITE_AI = 1,    // 흰 공도 서버가 침
+    MATCH_YELLOW_AI = 2,   // 노란 공은 세션 AI (AIFireYellowBall)
+};
+
+struct MsgHeader {
+    uint16_t type;
+    uint16_t size;      // 본문 길이
+    uint32_t session;
+};
+
+struct MsgCreate {
+    int32_t  winScore;
+    uint32_t flags;
+    uint32_t seed;      // 0 이면 서버가 정함
+};
+
+struct MsgShot {
+    float targetX, targetZ;
+};
+
+struct MsgPlay {
+    int32_t maxShots;
+};
+
+struct MsgState {
+    float   ball[4][2];   // ball number 0: r, 1: r, 2: y, 3: w 의 (x, z)
+    float   targetX, targetZ;
+    int32_t isWhiteTurn;
+    int32_t whiteScore, yellowScore;
+    int32_t winner;       // 0: 진행 중, 2: yellow, 3: white
+    int32_t shots;        // 이 요청으로 친 샷 수
+    int32_t lastScore;    // 마지막 샷의 getScore
+};
+
+struct MsgError {
+    int32_t code;
+};
+
+#endif // __matchProtocolH__
@@ -0,0 +1,744 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: matchServer.cpp
+//
+// Desc: 화면 없이 여러 판을 동시에 돌리는 로컬 대전 서버 (Linux, Unix domain socket + epoll).
+//       프로토콜은 matchProtocol.h. 연결은 shard (스레드 하나 + epoll 하나) 에 나눠 붙이고,
+//       그 연결에서 만든 판은 그 shard 에서만 돌아가므로 shard 끼리 잠금이 필요 없음.
+//       턴 진행은 WndProc 의 VK_SPACE 와 Display() 의 allStopped/updateScore 를 그대로 따름
+//       (CGameSession::fire/fireAt + step). 서버는 실시간으로 기다리지 않고 샷을 끝까지 바로 계산.
+//
+//       서버:   matchServer [-s path] [-j shards] [-win N] [-policy file] [-mlp file] [-plan ms] [-aim] [-det]
+//               -aim: 플래너가 없을 때 노란 공 AI 가 샷마다 CEM 조준 (aimOptimizer.h).
+//               -det: 결정적 모드 (Fixed 물리). 같은 샷이면 어느 빌드에서나 같은 결과.
+//       부하:   matchServer -bench [-s path] [-c connections] [-n shots per connection]
+//       할당:   matchServer -alloc [-n shots] [-policy file] [-mlp file] [-plan ms] [-det]
+//               소켓 없이 Q-table, 플래너 (-plan 이 없으면 20ms), CEM 조준으로 한 판씩 n 샷을 돌리며
+//               물리 / AI 조준 구간의 힙 할당을 검사 (allocTrack.h).
+//               -DUSE_ALLOC_TRACK 과 allocTrack.cpp 를 더해 빌드. 금지 구간에서 할당하면 1 반환.
+//
+//       빌드:   g++ -O2 -std=c++14 -pthread matchServer.cpp gameSession.cpp billiardSim.cpp
+//                   shotPlanner.cpp aimOptimizer.cpp rayCaster.cpp qTable.cpp policyTable.cpp
+//                   neuralPolicy.cpp -o matchServer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "matchProtocol.h"
+#include "gameSession.h"
+#include "allocTrack.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static std::atomic<bool> s_quit(false);
+
+static void onSignal(int)
+{
+    s_quit = true;
+}
+
+// -----------------------------------------------------------------------------
+// 서버
+// -----------------------------------------------------------------------------
+
+struct ServerConfig {
+    std::string path;
+    int   shards;
+    int   winScore;
+    const CPolicyTable*  policy;
+    const CNeuralPolicy* mlp;
+    CShotPlanner*        planner;
+    CAimOptimizer*       aim;
+    bool  deterministic;   // 판마다 결정적 (Fixed) 물리
+};
+
+// 판 하나 + 어느 쪽을 서버가 치는지
+struct Match {
+    CGameSession session;
+    unsigned     flags;
+    int          conn;   // 만든 연결의 fd (연결이 끊기면 같이 정리)
+
+    Match(unsigned seed) : session(seed), flags(0), conn(-1) {}
+};
+
+struct Connection {
+    int fd;
+    bool wantWrite;   // EPOLLOUT 을 등록해 둔 상태
+    std::vector<char> in;
+    std::vector<char> out;
+    std::vector<uint32_t> matches;
+};
+
+class CMatchShard {
+public:
+    CMatchShard(int index, const ServerConfig& cfg);
+    ~CMatchShard();
+
+    void addConnection(int fd);   // 다른 스레드 (accept) 에서 부름
+    void run();
+
+private:
+    void acceptPending();
+    void onReadable(Connection* c);
+    void flush(Connection* c);
+    void closeConnection(Connection* c);
+    void handle(Connection* c, const MsgHeader& h, const char* body);
+
+    Match* find(uint32_t id);
+    void   reply(Connection* c, uint32_t id, Match* m, int shots, int lastScore);
+    void   replyError(Connection* c, uint32_t id, int code);
+    int    playTurn(Match* m, bool byAI);   // 한 샷을 멈출 때까지. 그 샷의 getScore 반환.
+    bool   isAITurn(const Match* m) const;
+
+    int  m_index;
+    const ServerConfig& m_cfg;
+    int  m_epoll;
+    int  m_wake;   // eventfd: 새 연결 알림
+
+    std::mutex       m_pendingMutex;
+    std::vector<int> m_pending;
+
+    std::unordered_map<int, Connection*> m_conns;
+    std::vector<Match*>   m_matches;   // session 번호의 하위 24 bit = 인덱스
+    std::vector<uint32_t> m_free;
+    std::mt19937          m_rng;
+};
+
+CMatchShard::CMatchShard(int index, const ServerConfig& cfg)
+    : m_index(index), m_cfg(cfg), m_rng(index * 7919 + 1)
+{
+    m_epoll = epoll_create1(0);
+    m_wake = eventfd(0, EFD_NONBLOCK);
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = m_wake;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &ev);
+}
+
+CMatchShard::~CMatchShard()
+{
+    for (auto& kv : m_conns) {
+        close(kv.first);
+        delete kv.second;
+    }
+    for (Match* m : m_matches) delete m;
+    close(m_wake);
+    close(m_epoll);
+}
+
+void CMatchShard::addConnection(int fd)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending.push_back(fd);
+    }
+    uint64_t one = 1;
+    if (write(m_wake, &one, sizeof(one)) < 0) {}
+}
+
+void CMatchShard::acceptPending()
+{
+    uint64_t n;
+    if (read(m_wake, &n, sizeof(n)) < 0) {}
+
+    std::vector<int> fds;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        fds.swap(m_pending);
+    }
+    for (int fd : fds) {
+        Connection* c = new Connection;
+        c->fd = fd;
+        c->wantWrite = false;
+        m_conns[fd] = c;
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+void CMatchShard::run()
+{
+    const int MAX_EVENTS = 256;
+    epoll_event events[MAX_EVENTS];
+
+    while (!s_quit) {
+        int n = epoll_wait(m_epoll, events, MAX_EVENTS, 100);
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == m_wake) {
+                acceptPending();
+                continue;
+            }
+            auto it = m_conns.find(fd);
+            if (it == m_conns.end()) continue;
+            Connection* c = it->second;
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(c);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) flush(c);
+            if (events[i].events & EPOLLIN) onReadable(c);
+        }
+    }
+}
+
+void CMatchShard::onReadable(Connection* c)
+{
+    char buf[16384];
+    for (;;) {
+        ssize_t r = recv(c->fd, buf, sizeof(buf), 0);
+        if (r > 0) {
+            c->in.insert(c->in.end(), buf, buf + r);
+            continue;
+        }
+        if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            closeConnection(c);
+            return;
+        }
+        break;
+    }
+
+    // 다 받은 메시지만 처리
+    size_t pos = 0;
+    while (c->in.size() - pos >= sizeof(MsgHeader)) {
+        MsgHeader h;
+        memcpy(&h, &c->in[pos], sizeof(h));
+        if (h.size > MATCH_MAX_PAYLOAD) {
+            closeConnection(c);
+            return;
+        }
+        if (c->in.size() - pos < sizeof(h) + h.size) break;
+        handle(c, h, &c->in[pos + sizeof(h)]);
+        pos += sizeof(h) + h.size;
+    }
+    c->in.erase(c->in.begin(), c->in.begin() + pos);
+    flush(c);
+}
+
+void CMatchShard::flush(Connection* c)
+{
+    size_t sent = 0;
+    while (sent < c->out.size()) {
+        ssize_t w = send(c->fd, &c->out[sent], c->out.size() - sent, MSG_NOSIGNAL);
+        if (w <= 0) break;
+        sent += (size_t)w;
+    }
+    c->out.erase(c->out.begin(), c->out.begin() + sent);
+
+    // 다 못 보냈으면 쓸 수 있을 때 다시
+    bool want = !c->out.empty();
+    if (want != c->wantWrite) {
+        epoll_event ev;
+        ev.events = EPOLLIN | (want ? (uint32_t)EPOLLOUT : 0u);
+        ev.data.fd = c->fd;
+        epoll_ctl(m_epoll, EPOLL_CTL_MOD, c->fd, &ev);
+        c->wantWrite = want;
+    }
+}
+
+void CMatchShard::closeConnection(Connection* c)
+{
+    for (uint32_t id : c->matches) {
+        uint32_t slot = id & 0xffffff;
+        if (slot < m_matches.size() && m_matches[slot]) {
+            delete m_matches[slot];
+            m_matches[slot] = NULL;
+            m_free.push_back(slot);
+        }
+    }
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    m_conns.erase(c->fd);
+    delete c;
+}
+
+Match* CMatchShard::find(uint32_t id)
+{
+    if ((int)(id >> 24) != m_index) return NULL;
+    uint32_t slot = id & 0xffffff;
+    return slot < m_matches.size() ? m_matches[slot] : NULL;
+}
+
+bool CMatchShard::isAITurn(const Match* m) const
+{
+    int turn = m->session.isWhiteTurn();
+    return (turn == 1 && (m->flags & MATCH_WHITE_AI)) ||
+           (turn == -1 && (m->flags & MATCH_YELLOW_AI));
+}
+
+int CMatchShard::playTurn(Match* m, bool byAI)
+{
+    CGameSession& g = m->session;
+    int turn = g.isWhiteTurn();
+    int before = turn == 1 ? g.whiteScore() : g.yellowScore();
+
+    if (byAI && turn == 1) {
+        // 흰 공 AI: 플래너가 있으면 탐색, 없으면 아무 방향 (세션 AI 는 노란 공 전용)
+        const SimBall& white = g.world().ball[BALL_WHITE];
+        float tx, tz;
+        if (m_cfg.planner) {
+            PlannedShot shot = m_cfg.planner->plan(g.world(), 1);
+            tx = shot.targetX;
+            tz = shot.targetZ;
+        }
+        else {
+            std::uniform_real_distribution<float> angle(0, 6.2831853f), power(1.0f, 8.0f);
+            float a = angle(m_rng), p = power(m_rng);
+            tx = white.x + p * cosf(a);
+            tz = white.z + p * sinf(a);
+        }
+        g.fireAt(tx, tz);
+    }
+    else if (byAI) {
+        g.fire();   // 노란 공: AIFireYellowBall
+    }
+
+    for (int i = 0; i < SIM_MAX_STEPS; i++) {
+        if (g.step(SIM_TIME_STEP)) break;
+    }
+
+    // updateScore 는 +1/-1 을 그대로 더하므로 점수 차가 곧 getScore
+    int after = turn == 1 ? g.whiteScore() : g.yellowScore();
+    return after - before;
+}
+
+void CMatchShard::reply(Connection* c, uint32_t id, Match* m, int shots, int lastScore)
+{
+    MsgHeader h;
+    h.type = MSG_STATE;
+    h.size = sizeof(MsgState);
+    h.session = id;
+
+    const CGameSession& g = m->session;
+    MsgState st;
+    for (int i = 0; i < SIM_BALLS; i++) {
+        st.ball[i][0] = g.world().ball[i].x;
+        st.ball[i][1] = g.world().ball[i].z;
+    }
+    st.targetX = g.getTargetX();
+    st.targetZ = g.getTargetZ();
+    st.isWhiteTurn = g.isWhiteTurn();
+    st.whiteScore = g.whiteScore();
+    st.yellowScore = g.yellowScore();
+    st.winner = g.winner();
+    st.shots = shots;
+    st.lastScore = lastScore;
+
+    c->out.insert(c->out.end(), (const char*)&h, (const char*)&h + sizeof(h));
+    c->out.insert(c->out.end(), (const char*)&st, (const char*)&st + sizeof(st));
+}
+
+void CMatchShard::replyError(Connection* c, uint32_t id, int code)
+{
+    MsgHeader h;
+    h.type = MSG_ERROR;
+    h.size = sizeof(MsgError);
+    h.session = id;
+    MsgError e;
+    e.code = code;
+    c->out.insert(c->out.end(), (const char*)&h, (const char*)&h + sizeof(h));
+    c->out.insert(c->out.end(), (const char*)&e, (const char*)&e + sizeof(e));
+}
+
+void CMatchShard::handle(Connection* c, const MsgHeader& h, const char* body)
+{
+    if (h.type == MSG_CREATE) {
+        if (h.size != sizeof(MsgCreate)) { replyError(c, h.session, MATCH_ERR_BAD_MESSAGE); return; }
+        MsgCreate req;
+        memcpy(&req, body, sizeof(req));
+
+        uint32_t slot;
+        if (!m_free.empty()) {
+            slot = m_free.back();
+            m_free.pop_back();
+        }
+        else if (m_matches.size() < 0xffffff) {
+            slot = (uint32_t)m_matches.size();
+            m_matches.push_back(NULL);
+        }
+        else {
+            replyError(c, 0, MATCH_ERR_FULL);
+            return;
+        }
+
+        Match* m = new Match(req.seed ? req.seed : (unsigned)m_rng());
+        m->flags = req.flags;
+        m->conn = c->fd;
+        m->session.setWinScore(req.winScore > 0 ? req.winScore : m_cfg.winScore);
+        m->session.setDeterministic(m_cfg.deterministic);
+
+        // 서버 세션은 학습/저장 없이 공유 정책만 씀
+        SessionAI& ai = m->session.ai();
+        ai.learning = false;
+        ai.replayPath.clear();
+        ai.policy = m_cfg.policy;
+        ai.mlp = m_cfg.mlp;
+        ai.planner = m_cfg.planner;
+        ai.aim = m_cfg.aim;
+
+        m_matches[slot] = m;
+        uint32_t id = ((uint32_t)m_index << 24) | slot;
+        c->matches.push_back(id);
+        reply(c, id, m, 0, 0);
+        return;
+    }
+
+    Match* m = find(h.session);
+    if (!m || m->conn != c->fd) { replyError(c, h.session, MATCH_ERR_NO_SESSION); return; }
+
+    switch (h.type) {
+    case MSG_SHOT:
+    {
+        if (h.size != sizeof(MsgShot)) { replyError(c, h.session, MATCH_ERR_BAD_MESSAGE); return; }
+        if (m->session.winner()) { replyError(c, h.session, MATCH_ERR_GAME_OVER); return; }
+        if (isAITurn(m)) { replyError(c, h.session, MATCH_ERR_NOT_YOUR_TURN); return; }
+        MsgShot req;
+        memcpy(&req, body, sizeof(req));
+        m->session.fireAt(req.targetX, req.targetZ);
+        int last = playTurn(m, false);
+        int shots = 1;
+        while (shots <= MATCH_AUTO_SHOTS && !m->session.winner() && isAITurn(m)) {
+            last = playTurn(m, true);
+            shots++;
+        }
+        reply(c, h.session, m, shots, last);
+        break;
+    }
+    case MSG_PLAY:
+    {
+        if (h.size != sizeof(MsgPlay)) { replyError(c, h.session, MATCH_ERR_BAD_MESSAGE); return; }
+        MsgPlay req;
+        memcpy(&req, body, sizeof(req));
+        int shots = 0, last = 0;
+        while (shots < req.maxShots && !m->session.winner() && isAITurn(m)) {
+            last = playTurn(m, true);
+            shots++;
+        }
+        reply(c, h.session, m, shots, last);
+        break;
+    }
+    case MSG_QUERY:
+        reply(c, h.session, m, 0, 0);
+        break;
+    case MSG_CLOSE:
+    {
+        uint32_t slot = h.session & 0xffffff;
+        reply(c, h.session, m, 0, 0);
+        delete m;
+        m_matches[slot] = NULL;
+        m_free.push_back(slot);
+        c->matches.erase(std::find(c->matches.begin(), c->matches.end(), h.session));
+        break;
+    }
+    default:
+        replyError(c, h.session, MATCH_ERR_BAD_MESSAGE);
+        break;
+    }
+}
+
+static int runServer(const ServerConfig& cfg)
+{
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, cfg.path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(cfg.path.c_str());
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 1024) < 0) {
+        perror("bind/listen");
+        return 1;
+    }
+
+    std::vector<CMatchShard*> shards;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < cfg.shards; i++) shards.push_back(new CMatchShard(i, cfg));
+    for (int i = 0; i < cfg.shards; i++) threads.emplace_back([&shards, i] { shards[i]->run(); });
+    printf("matchServer: %s, %d shards\n", cfg.path.c_str(), cfg.shards);
+
+    // accept 는 이 스레드에서, 연결은 shard 에 돌아가며 붙임
+    epoll_event ev;
+    int ep = epoll_create1(0);
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    epoll_ctl(ep, EPOLL_CTL_ADD, listenFd, &ev);
+    int next = 0;
+    while (!s_quit) {
+        if (epoll_wait(ep, &ev, 1, 100) <= 0) continue;
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        shards[next]->addConnection(fd);
+        next = (next + 1) % cfg.shards;
+    }
+
+    for (auto& t : threads) t.join();
+    for (CMatchShard* s : shards) delete s;
+    close(ep);
+    close(listenFd);
+    unlink(cfg.path.c_str());
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// 부하 클라이언트: 연결마다 스레드 하나, 흰 공은 클라이언트가 치고 노란 공은 서버 AI
+// -----------------------------------------------------------------------------
+
+static bool sendAll(int fd, const void* data, size_t size)
+{
+    const char* p = (const char*)data;
+    while (size > 0) {
+        ssize_t w = send(fd, p, size, MSG_NOSIGNAL);
+        if (w <= 0) return false;
+        p += w;
+        size -= (size_t)w;
+    }
+    return true;
+}
+
+static bool recvAll(int fd, void* data, size_t size)
+{
+    char* p = (char*)data;
+    while (size > 0) {
+        ssize_t r = recv(fd, p, size, 0);
+        if (r <= 0) return false;
+        p += r;
+        size -= (size_t)r;
+    }
+    return true;
+}
+
+// 요청 하나 보내고 응답 받기. 응답이 MSG_STATE 면 true.
+static bool request(int fd, uint16_t type, uint32_t session, const void* body, uint16_t size,
+                    MsgHeader& rh, MsgState& st)
+{
+    char buf[sizeof(MsgHeader) + MATCH_MAX_PAYLOAD];
+    MsgHeader h;
+    h.type = type;
+    h.size = size;
+    h.session = session;
+    memcpy(buf, &h, sizeof(h));
+    if (size) memcpy(buf + sizeof(h), body, size);
+    if (!sendAll(fd, buf, sizeof(h) + size)) return false;
+
+    if (!recvAll(fd, &rh, sizeof(rh)) || rh.size > MATCH_MAX_PAYLOAD) return false;
+    char payload[MATCH_MAX_PAYLOAD];
+    if (!recvAll(fd, payload, rh.size)) return false;
+    if (rh.type != MSG_STATE || rh.size != sizeof(MsgState)) return false;
+    memcpy(&st, payload, sizeof(st));
+    return true;
+}
+
+static int runBench(const std::string& path, int conns, int shotsPerConn)
+{
+    std::vector<std::vector<double> > latency(conns);
+    std::atomic<int> games(0), failed(0);
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int ci = 0; ci < conns; ci++) {
+        threads.emplace_back([&, ci] {
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+            if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+                failed++;
+                close(fd);
+                return;
+            }
+
+            std::mt19937 rng(ci + 1);
+            std::uniform_real_distribution<float> ux(-4.0f, 4.0f), uz(-2.5f, 2.5f);
+            MsgHeader rh;
+            MsgState st;
+            MsgCreate create = { 3, MATCH_YELLOW_AI, (uint32_t)(ci + 1) };
+            uint32_t session = 0;
+            bool open = false;
+
+            for (int s = 0; s < shotsPerConn; s++) {
+                if (!open) {
+                    if (!request(fd, MSG_CREATE, 0, &create, sizeof(create), rh, st)) { failed++; break; }
+                    session = rh.session;
+                    open = true;
+                }
+                MsgShot shot = { ux(rng), uz(rng) };
+                auto s0 = std::chrono::steady_clock::now();
+                bool ok = request(fd, MSG_SHOT, session, &shot, sizeof(shot), rh, st);
+                latency[ci].push_back(std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - s0).count());
+                if (!ok) { failed++; break; }
+                if (st.winner) {
+                    request(fd, MSG_CLOSE, session, NULL, 0, rh, st);
+                    open = false;
+                    games++;
+                }
+            }
+            close(fd);
+        });
+    }
+    for (auto& t : threads) t.join();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::vector<double> all;
+    for (auto& v : latency) all.insert(all.end(), v.begin(), v.end());
+    if (all.empty()) {
+        printf("no replies (failed %d)\n", (int)failed);
+        return 1;
+    }
+    std::sort(all.begin(), all.end());
+    printf("%zu shots, %d finished games, %d failed, %.0f shots/s\n",
+           all.size(), (int)games, (int)failed, all.size() / sec);
+    printf("latency us: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+           all[all.size() / 2], all[all.size() * 9 / 10], all[all.size() * 99 / 100], all.back());
+    return failed ? 1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+// 할당 검사: 흰 공은 아무 방향, 노란 공은 세션 AI (풀이 있으면 게임처럼 executor 에서 조준).
+// AI 조준 방법마다 (Q-table, 플래너, CEM) 새 판을 하나씩 돌림.
+// -----------------------------------------------------------------------------
+
+#ifdef USE_ALLOC_TRACK
+static void playAllocCheck(const char* name, const ServerConfig& cfg, CThreadPool* pool, int shots,
+                           CShotPlanner* planner, CAimOptimizer* aim)
+{
+    CGameSession g(1);
+    g.setWinScore(1 << 30);   // 끝나지 않게
+    g.setDeterministic(cfg.deterministic);
+    SessionAI& ai = g.ai();
+    ai.replayPath.clear();   // 학습은 메모리에서만 (턴 끝 "learning" 구간)
+    ai.policy = cfg.policy;
+    ai.mlp = cfg.mlp;
+    ai.planner = planner;
+    ai.aim = aim;
+    ai.executor = pool && pool->size() > 0 ? pool : NULL;   // worker 가 없으면 submit 한 조준이 안 돎
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> ux(-4.0f, 4.0f), uz(-2.5f, 2.5f);
+    for (int s = 0; s < shots; s++) {
+        if (g.isWhiteTurn() == 1) g.fireAt(ux(rng), uz(rng));
+        else g.fire();
+        while (!g.step(SIM_TIME_STEP)) {}
+    }
+    g.waitBackground();
+    printf("%-8s %d shots, violations so far %lld\n", name, shots, (long long)allocViolations());
+}
+#endif
+
+static int runAllocCheck(const ServerConfig& cfg, CThreadPool* pool, int shots)
+{
+#ifndef USE_ALLOC_TRACK
+    (void)cfg;
+    (void)pool;
+    (void)shots;
+    fprintf(stderr, "-alloc: build with -DUSE_ALLOC_TRACK and allocTrack.cpp\n");
+    return 1;
+#else
+    playAllocCheck("qtable", cfg, pool, shots, NULL, NULL);
+    playAllocCheck("plan", cfg, pool, shots, cfg.planner, NULL);
+    playAllocCheck("aim", cfg, pool, shots, NULL, cfg.aim);
+
+    allocReport(stdout);
+    return allocViolations() ? 1 : 0;
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    ServerConfig cfg;
+    cfg.path = MATCH_SOCKET_PATH;
+    cfg.shards = (int)std::thread::hardware_concurrency();
+    if (cfg.shards < 1) cfg.shards = 1;
+    cfg.winScore = 3;
+    cfg.policy = NULL;
+    cfg.mlp = NULL;
+    cfg.planner = NULL;
+    cfg.aim = NULL;
+    cfg.deterministic = false;
+
+    bool bench = false, allocCheck = false, useAim = false;
+    int conns = 64, shots = 1000;
+    const char* policyPath = NULL;
+    const char* mlpPath = NULL;
+    double planMs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool more = i + 1 < argc;
+        if (a == "-bench") bench = true;
+        else if (a == "-alloc") allocCheck = true;
+        else if (a == "-s" && more) cfg.path = argv[++i];
+        else if (a == "-j" && more) cfg.shards = std::max(1, atoi(argv[++i]));
+        else if (a == "-win" && more) cfg.winScore = atoi(argv[++i]);
+        else if (a == "-policy" && more) policyPath = argv[++i];
+        else if (a == "-mlp" && more) mlpPath = argv[++i];
+        else if (a == "-plan" && more) planMs = atof(argv[++i]);
+        else if (a == "-aim") useAim = true;
+        else if (a == "-det") cfg.deterministic = true;
+        else if (a == "-c" && more) conns = atoi(argv[++i]);
+        else if (a == "-n" && more) shots = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: matchServer [-s path] [-j shards] [-win N] [-policy file] [-mlp file] [-plan ms] [-aim] [-det]\n"
+                            "       matchServer -bench [-s path] [-c connections] [-n shots]\n"
+                            "       matchServer -alloc [-n shots] [-policy file] [-mlp file] [-plan ms] [-det]\n");
+            return 1;
+        }
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (bench) return runBench(cfg.path, conns, shots);
+
+    CPolicyTable policy;
+    if (policyPath && policy.open(policyPath)) cfg.policy = &policy;
+    CNeuralPolicy mlp;
+    if (mlpPath && mlp.load(mlpPath)) cfg.mlp = &mlp;
+    if (allocCheck) {
+        // 할당 검사는 AI 조준 방법을 모두 돎
+        if (planMs <= 0) planMs = 20;
+        useAim = true;
+    }
+    CThreadPool* pool = NULL;
+    CShotPlanner* planner = NULL;
+    CAimOptimizer* aim = NULL;
+    if (planMs > 0 || useAim) pool = new CThreadPool();
+    if (planMs > 0) {
+        PlannerConfig pc = DefaultPlannerConfig();
+        pc.timeBudgetMs = planMs;
+        planner = new CShotPlanner(*pool, pc);
+        cfg.planner = planner;
+    }
+    if (useAim) {
+        aim = new CAimOptimizer(*pool);
+        cfg.aim = aim;
+    }
+
+    int ret = allocCheck ? runAllocCheck(cfg, pool, shots) : runServer(cfg);
+    delete aim;
+    delete planner;
+    delete pool;
+    return ret;
+}
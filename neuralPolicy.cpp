@@ -0,0 +1,280 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: neuralPolicy.cpp
+//
+// Desc: MLP 정책의 추론 (SSE, 힙 할당 없음) 과 오프라인 학습
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "neuralPolicy.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+#include <xmmintrin.h>
+#define MLP_USE_SSE 1
+#endif
+
+static const int MLP_VERSION = 1;
+static const int MLP_PARAM_COUNT = sizeof(MLPWeights) / sizeof(float);
+
+CNeuralPolicy::CNeuralPolicy() : m_loaded(false) {
+    memset(&m_w, 0, sizeof(m_w));
+}
+
+bool CNeuralPolicy::load(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+    char magic[4];
+    int header[4];
+    bool ok = fread(magic, 1, 4, fp) == 4 && memcmp(magic, "PBNN", 4) == 0 &&
+        fread(header, sizeof(int), 4, fp) == 4 &&
+        header[0] == MLP_VERSION && header[1] == MLP_INPUTS &&
+        header[2] == MLP_HIDDEN1 && header[3] == MLP_HIDDEN2 &&
+        fread(&m_w, sizeof(float), MLP_PARAM_COUNT, fp) == (size_t)MLP_PARAM_COUNT;
+    fclose(fp);
+    m_loaded = ok;
+    return ok;
+}
+
+bool CNeuralPolicy::save(const char* path) const {
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return false;
+    int header[4] = { MLP_VERSION, MLP_INPUTS, MLP_HIDDEN1, MLP_HIDDEN2 };
+    bool ok = fwrite("PBNN", 1, 4, fp) == 4 &&
+        fwrite(header, sizeof(int), 4, fp) == 4 &&
+        fwrite(&m_w, sizeof(float), MLP_PARAM_COUNT, fp) == (size_t)MLP_PARAM_COUNT;
+    return (fclose(fp) == 0) && ok;
+}
+
+// -----------------------------------------------------------------------------
+// 추론
+// -----------------------------------------------------------------------------
+
+// 은닉층 1 출력 (ReLU 전) 이 주어졌을 때 나머지 층을 계산
+static float forwardFromHidden1(const MLPWeights& w, const float* z1) {
+#ifdef MLP_USE_SSE
+    const __m128 zero = _mm_setzero_ps();
+    __m128 acc[MLP_HIDDEN2 / 4];
+    for (int k = 0; k < MLP_HIDDEN2 / 4; k++) acc[k] = _mm_loadu_ps(&w.b2[k * 4]);
+    for (int j = 0; j < MLP_HIDDEN1; j++) {
+        float h = z1[j] > 0 ? z1[j] : 0;
+        if (h == 0) continue;   // ReLU 로 죽은 뉴런은 건너뜀
+        __m128 hv = _mm_set1_ps(h);
+        for (int k = 0; k < MLP_HIDDEN2 / 4; k++)
+            acc[k] = _mm_add_ps(acc[k], _mm_mul_ps(hv, _mm_loadu_ps(&w.w2[j][k * 4])));
+    }
+    __m128 sum = zero;
+    for (int k = 0; k < MLP_HIDDEN2 / 4; k++)
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_max_ps(acc[k], zero), _mm_loadu_ps(&w.w3[k * 4])));
+    float lanes[4];
+    _mm_storeu_ps(lanes, sum);
+    return w.b3 + (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+    float z2[MLP_HIDDEN2];
+    for (int k = 0; k < MLP_HIDDEN2; k++) z2[k] = w.b2[k];
+    for (int j = 0; j < MLP_HIDDEN1; j++) {
+        float h = z1[j] > 0 ? z1[j] : 0;
+        if (h == 0) continue;
+        for (int k = 0; k < MLP_HIDDEN2; k++) z2[k] += h * w.w2[j][k];
+    }
+    float y = w.b3;
+    for (int k = 0; k < MLP_HIDDEN2; k++) y += (z2[k] > 0 ? z2[k] : 0) * w.w3[k];
+    return y;
+#endif
+}
+
+// z1 = b1 + sum_i x[i] * w1[i]  (i = first .. last-1)
+static void accumulateHidden1(const MLPWeights& w, const float* x, int first, int last,
+    const float* base, float* z1) {
+#ifdef MLP_USE_SSE
+    for (int j = 0; j < MLP_HIDDEN1; j += 4) {
+        __m128 acc = _mm_loadu_ps(&base[j]);
+        for (int i = first; i < last; i++)
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(x[i]), _mm_loadu_ps(&w.w1[i][j])));
+        _mm_storeu_ps(&z1[j], acc);
+    }
+#else
+    for (int j = 0; j < MLP_HIDDEN1; j++) {
+        float acc = base[j];
+        for (int i = first; i < last; i++) acc += x[i] * w.w1[i][j];
+        z1[j] = acc;
+    }
+#endif
+}
+
+float CNeuralPolicy::evaluate(const float in[MLP_INPUTS]) const {
+    float x[MLP_INPUTS];
+    for (int i = 0; i < MLP_INPUTS; i++) x[i] = in[i] * MLP_INPUT_SCALE;
+    float z1[MLP_HIDDEN1];
+    accumulateHidden1(m_w, x, 0, MLP_INPUTS, m_w.b1, z1);
+    return forwardFromHidden1(m_w, z1);
+}
+
+float CNeuralPolicy::bestAim(const float state[6], float& ax, float& az) const {
+    // 상태 부분 (입력 0~5) 은 모든 후보가 같으므로 한 번만 계산
+    float x[MLP_INPUTS];
+    for (int i = 0; i < 6; i++) x[i] = state[i] * MLP_INPUT_SCALE;
+    float base[MLP_HIDDEN1];
+    accumulateHidden1(m_w, x, 0, 6, m_w.b1, base);
+
+    float best = -1e30f;
+    ax = az = 0;
+    float z1[MLP_HIDDEN1];
+    for (int ix = 0; ix < MLP_AIM_NX; ix++) {
+        float cx = -MLP_AIM_RANGE_X + (ix + 0.5f) * (2 * MLP_AIM_RANGE_X / MLP_AIM_NX);
+        x[6] = cx * MLP_INPUT_SCALE;
+        for (int iz = 0; iz < MLP_AIM_NZ; iz++) {
+            float cz = -MLP_AIM_RANGE_Z + (iz + 0.5f) * (2 * MLP_AIM_RANGE_Z / MLP_AIM_NZ);
+            x[7] = cz * MLP_INPUT_SCALE;
+            accumulateHidden1(m_w, x, 6, 8, base, z1);
+            float y = forwardFromHidden1(m_w, z1);
+            if (y > best) {
+                best = y;
+                ax = cx;
+                az = cz;
+            }
+        }
+    }
+    return best;
+}
+
+// -----------------------------------------------------------------------------
+// 학습 데이터
+// -----------------------------------------------------------------------------
+
+// bin() 은 0 쪽으로 버림이므로 칸의 가운데는 ±0.25
+static float binCenter(int b) {
+    return b == 0 ? 0.0f : b * 0.5f + (b > 0 ? 0.25f : -0.25f);
+}
+
+void AppendQTableSamples(const std::vector<QEntry>& qTable, std::vector<PolicySample>& out) {
+    out.reserve(out.size() + qTable.size());
+    for (auto& e : qTable) {
+        PolicySample s;
+        const int* bins = &e.state.dx1;
+        for (int i = 0; i < MLP_INPUTS; i++) s.in[i] = binCenter(bins[i]);
+        s.reward = e.avgReward;
+        out.push_back(s);
+    }
+}
+
+bool LoadReplaySamples(const char* path, std::vector<PolicySample>& out) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) return false;
+    PolicySample s;
+    while (fscanf(fp, "%f %f %f %f %f %f %f %f %f",
+        &s.in[0], &s.in[1], &s.in[2], &s.in[3], &s.in[4], &s.in[5], &s.in[6], &s.in[7],
+        &s.reward) == 9) {
+        out.push_back(s);
+    }
+    fclose(fp);
+    return true;
+}
+
+void AppendReplaySample(const PolicySample& s, const char* path) {
+    FILE* fp = fopen(path, "a");
+    if (!fp) return;
+    fprintf(fp, "%f %f %f %f %f %f %f %f %f\n",
+        s.in[0], s.in[1], s.in[2], s.in[3], s.in[4], s.in[5], s.in[6], s.in[7], s.reward);
+    fclose(fp);
+}
+
+// -----------------------------------------------------------------------------
+// 학습 (스칼라 역전파 + Adam, 미니배치)
+// -----------------------------------------------------------------------------
+
+float TrainNeuralPolicy(CNeuralPolicy& policy, const std::vector<PolicySample>& samples,
+    int epochs, unsigned seed, bool verbose) {
+    if (samples.empty()) return 0;
+
+    const int BATCH = 64;
+    const float LR = 1e-3f, BETA1 = 0.9f, BETA2 = 0.999f, EPS = 1e-8f;
+
+    std::mt19937 rng(seed);
+    MLPWeights& w = policy.weights();
+    float* param = (float*)&w;
+
+    // He 초기화
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    memset(&w, 0, sizeof(w));
+    for (int i = 0; i < MLP_INPUTS; i++)
+        for (int j = 0; j < MLP_HIDDEN1; j++) w.w1[i][j] = normal(rng) * sqrtf(2.0f / MLP_INPUTS);
+    for (int j = 0; j < MLP_HIDDEN1; j++)
+        for (int k = 0; k < MLP_HIDDEN2; k++) w.w2[j][k] = normal(rng) * sqrtf(2.0f / MLP_HIDDEN1);
+    for (int k = 0; k < MLP_HIDDEN2; k++) w.w3[k] = normal(rng) * sqrtf(1.0f / MLP_HIDDEN2);
+
+    std::vector<float> grad(MLP_PARAM_COUNT), m(MLP_PARAM_COUNT, 0), v(MLP_PARAM_COUNT, 0);
+    MLPWeights& g = *(MLPWeights*)&grad[0];
+    std::vector<int> order(samples.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+
+    int step = 0;
+    float epochLoss = 0;
+    for (int epoch = 0; epoch < epochs; epoch++) {
+        for (size_t i = order.size() - 1; i > 0; i--) std::swap(order[i], order[rng() % (i + 1)]);
+        epochLoss = 0;
+
+        for (size_t start = 0; start < order.size(); start += BATCH) {
+            size_t end = start + BATCH < order.size() ? start + BATCH : order.size();
+            std::fill(grad.begin(), grad.end(), 0.0f);
+
+            for (size_t n = start; n < end; n++) {
+                const PolicySample& s = samples[order[n]];
+                float x[MLP_INPUTS], z1[MLP_HIDDEN1], h1[MLP_HIDDEN1], z2[MLP_HIDDEN2], h2[MLP_HIDDEN2];
+                for (int i = 0; i < MLP_INPUTS; i++) x[i] = s.in[i] * MLP_INPUT_SCALE;
+                for (int j = 0; j < MLP_HIDDEN1; j++) {
+                    z1[j] = w.b1[j];
+                    for (int i = 0; i < MLP_INPUTS; i++) z1[j] += x[i] * w.w1[i][j];
+                    h1[j] = z1[j] > 0 ? z1[j] : 0;
+                }
+                for (int k = 0; k < MLP_HIDDEN2; k++) {
+                    z2[k] = w.b2[k];
+                    for (int j = 0; j < MLP_HIDDEN1; j++) z2[k] += h1[j] * w.w2[j][k];
+                    h2[k] = z2[k] > 0 ? z2[k] : 0;
+                }
+                float y = w.b3;
+                for (int k = 0; k < MLP_HIDDEN2; k++) y += h2[k] * w.w3[k];
+
+                float dy = y - s.reward;
+                epochLoss += 0.5f * dy * dy;
+
+                float dz2[MLP_HIDDEN2];
+                g.b3 += dy;
+                for (int k = 0; k < MLP_HIDDEN2; k++) {
+                    g.w3[k] += dy * h2[k];
+                    dz2[k] = z2[k] > 0 ? dy * w.w3[k] : 0;
+                    g.b2[k] += dz2[k];
+                }
+                for (int j = 0; j < MLP_HIDDEN1; j++) {
+                    float dh1 = 0;
+                    for (int k = 0; k < MLP_HIDDEN2; k++) {
+                        g.w2[j][k] += h1[j] * dz2[k];
+                        dh1 += w.w2[j][k] * dz2[k];
+                    }
+                    float dz1 = z1[j] > 0 ? dh1 : 0;
+                    g.b1[j] += dz1;
+                    for (int i = 0; i < MLP_INPUTS; i++) g.w1[i][j] += x[i] * dz1;
+                }
+            }
+
+            // Adam
+            step++;
+            float inv = 1.0f / (float)(end - start);
+            float c1 = 1.0f - powf(BETA1, (float)step);
+            float c2 = 1.0f - powf(BETA2, (float)step);
+            for (int p = 0; p < MLP_PARAM_COUNT; p++) {
+                float gp = grad[p] * inv;
+                m[p] = BETA1 * m[p] + (1 - BETA1) * gp;
+                v[p] = BETA2 * v[p] + (1 - BETA2) * gp * gp;
+                param[p] -= LR * (m[p] / c1) / (sqrtf(v[p] / c2) + EPS);
+            }
+        }
+        epochLoss /= (float)samples.size();
+        if (verbose) printf("epoch %d  loss %.4f\n", epoch + 1, epochLoss);
+    }
+    policy.setLoaded(true);
+    return epochLoss;
+}
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: neuralPolicy.h
+//
+// Desc: Q-table 대신 쓸 수 있는 작은 신경망 (MLP) 정책.
+//       입력 8 개 = getCurrentState 의 재료인 연속 좌표 (노란공 기준 상대 위치)
+//           red1 (x, z), red2 (x, z), white (x, z), 조준점 (x, z)
+//       출력 1 개 = 그 조준으로 쳤을 때 예상 보상 (calculateAIPoint 기준).
+//       AI 는 정해진 조준 후보 격자를 전부 평가해서 가장 높은 것을 고름.
+//       가중치는 약 3KB (ai_policy_mlp.bin), 학습은 qTableTool train-mlp 로 오프라인에서.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __neuralPolicyH__
+#define __neuralPolicyH__
+
+#include "qTable.h"
+#include <vector>
+
+#define MLP_FILE    "ai_policy_mlp.bin"
+#define REPLAY_FILE "ai_replay.txt"
+
+const int MLP_INPUTS = 8;
+const int MLP_HIDDEN1 = 32;   // SIMD 폭(4) 의 배수
+const int MLP_HIDDEN2 = 16;
+
+// 조준 후보 격자 (노란공 기준 상대 좌표)
+const int   MLP_AIM_NX = 16;
+const int   MLP_AIM_NZ = 8;
+const float MLP_AIM_RANGE_X = 8.0f;
+const float MLP_AIM_RANGE_Z = 6.0f;
+
+// 좌표를 대략 [-1, 1] 로 맞추는 입력 스케일
+const float MLP_INPUT_SCALE = 1.0f / 8.0f;
+
+// 학습용 샘플: in = {dx1, dz1, dx2, dz2, dxw, dzw, ax, az} (정규화 전 좌표), 보상
+struct PolicySample {
+    float in[MLP_INPUTS];
+    float reward;
+};
+
+struct MLPWeights {
+    float w1[MLP_INPUTS][MLP_HIDDEN1];   // 입력 i 의 가중치가 연속으로 놓이도록 (SIMD 용)
+    float b1[MLP_HIDDEN1];
+    float w2[MLP_HIDDEN1][MLP_HIDDEN2];
+    float b2[MLP_HIDDEN2];
+    float w3[MLP_HIDDEN2];
+    float b3;
+};
+
+class CNeuralPolicy {
+public:
+    CNeuralPolicy();
+
+    bool load(const char* path = MLP_FILE);
+    bool save(const char* path = MLP_FILE) const;
+    bool isLoaded() const { return m_loaded; }
+
+    // 입력 하나의 예상 보상 (정규화 전 좌표)
+    float evaluate(const float in[MLP_INPUTS]) const;
+    // state = {dx1, dz1, dx2, dz2, dxw, dzw}. 후보 격자 중 예상 보상이 가장 높은 조준을 반환.
+    float bestAim(const float state[6], float& ax, float& az) const;
+
+    MLPWeights&       weights() { return m_w; }
+    const MLPWeights& weights() const { return m_w; }
+    void setLoaded(bool loaded) { m_loaded = loaded; }
+
+private:
+    MLPWeights m_w;
+    bool       m_loaded;
+};
+
+// Q-table 엔트리를 샘플로 변환 (bin 칸의 가운데 좌표 사용)
+void AppendQTableSamples(const std::vector<QEntry>& qTable, std::vector<PolicySample>& out);
+// 게임이 남긴 replay 로그 ("dx1 dz1 dx2 dz2 dxw dzw ax az reward" 한 줄씩) 를 읽음
+bool LoadReplaySamples(const char* path, std::vector<PolicySample>& out);
+// 한 턴 결과를 replay 로그에 덧붙임
+void AppendReplaySample(const PolicySample& s, const char* path = REPLAY_FILE);
+
+// Adam 으로 MSE 학습. 마지막 epoch 의 평균 loss 반환.
+float TrainNeuralPolicy(CNeuralPolicy& policy, const std::vector<PolicySample>& samples,
+    int epochs, unsigned seed, bool verbose = false);
+
+#endif // __neuralPolicyH__
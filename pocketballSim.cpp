@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: pocketballSim.cpp
+//
+// Desc: libpocketball_sim 의 C ABI 구현. billiardSim 의 SimWorld 를 판마다 스택에 두고
+//       CThreadPool::parallelFor 로 나눠 돌림. C 경계 밖으로 예외가 나가지 않게 모두 잡음.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "pocketballSim.h"
+#include "billiardSim.h"
+#include "threadPool.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+// 부르는 쪽 배열을 SimBall / hit 에 그대로 복사하므로 배치가 같아야 함
+static_assert(sizeof(PbSimBall) == sizeof(SimBall) && offsetof(PbSimBall, x) == offsetof(SimBall, x) &&
+              offsetof(PbSimBall, z) == offsetof(SimBall, z) && offsetof(PbSimBall, vx) == offsetof(SimBall, vx) &&
+              offsetof(PbSimBall, vz) == offsetof(SimBall, vz), "PbSimBall layout");
+static_assert(sizeof(PbSimBall[PBSIM_BALLS]) == sizeof(((SimWorld*)0)->ball), "PbSimBall count");
+static_assert(sizeof(uint8_t[PBSIM_BALLS]) == sizeof(((SimWorld*)0)->hit), "hit layout");
+static_assert(sizeof(PbSimShot) == 12, "PbSimShot layout");
+
+struct PbSimBatch {
+    int          count;
+    CThreadPool* pool;
+    void*        buffer[PBSIM_BUF_COUNT];
+};
+
+int pbSimVersion(void)
+{
+    return PBSIM_VERSION;
+}
+
+const char* pbSimErrorString(int code)
+{
+    switch (code) {
+    case PBSIM_OK: return "ok";
+    case PBSIM_ERR_ARGUMENT: return "invalid argument";
+    case PBSIM_ERR_NO_BUFFER: return "balls or shots buffer not set";
+    case PBSIM_ERR_BAD_SHOT: return "shot ball must be 0..3 with a finite target";
+    case PBSIM_ERR_INTERNAL: return "out of memory or threads";
+    }
+    return "unknown error";
+}
+
+PbSimBatch* pbSimCreate(int count, int threads)
+{
+    if (count < 0) return NULL;
+    PbSimBatch* batch = new (std::nothrow) PbSimBatch;
+    if (!batch) return NULL;
+    batch->count = count;
+    memset(batch->buffer, 0, sizeof(batch->buffer));
+    try {
+        batch->pool = new CThreadPool(threads < 0 ? -1 : threads);
+    }
+    catch (...) {
+        delete batch;
+        return NULL;
+    }
+    return batch;
+}
+
+void pbSimDestroy(PbSimBatch* batch)
+{
+    if (!batch) return;
+    delete batch->pool;
+    delete batch;
+}
+
+int pbSimCount(const PbSimBatch* batch)
+{
+    return batch ? batch->count : 0;
+}
+
+int pbSimSetBuffer(PbSimBatch* batch, int buffer, void* data)
+{
+    if (!batch || buffer < 0 || buffer >= PBSIM_BUF_COUNT) return PBSIM_ERR_ARGUMENT;
+    batch->buffer[buffer] = data;
+    return PBSIM_OK;
+}
+
+// 한 판: 부르는 쪽 배열 -> 스택의 SimWorld -> 샷 -> 결과를 다시 부르는 쪽 배열로
+static void runOne(const PbSimBatch& batch, int i, int flags)
+{
+    PbSimBall* balls = (PbSimBall*)batch.buffer[PBSIM_BUF_BALLS] + (size_t)i * PBSIM_BALLS;
+    const PbSimShot& shot = ((const PbSimShot*)batch.buffer[PBSIM_BUF_SHOTS])[i];
+
+    SimWorld w;
+    simReset(w);
+    memcpy(w.ball, balls, sizeof(w.ball));
+    simClearHits(w);
+    simFire(w, shot.ball, shot.targetX, shot.targetZ);
+
+    int steps = (flags & PBSIM_RUN_HITS_ONLY) ? simRunHits(w) : simRun(w);
+
+    // 점수는 멈춘 시점의 hit 로 (updateScore 와 같음). 그 뒤 정리 중의 접촉은 세지 않음.
+    if (batch.buffer[PBSIM_BUF_HITS])
+        memcpy((uint8_t*)batch.buffer[PBSIM_BUF_HITS] + (size_t)i * PBSIM_BALLS, w.hit, sizeof(w.hit));
+    if (batch.buffer[PBSIM_BUF_SCORES]) {
+        int isWhiteTurn = shot.ball == BALL_WHITE ? 1 : shot.ball == BALL_YELLOW ? -1 : 0;
+        ((int32_t*)batch.buffer[PBSIM_BUF_SCORES])[i] = simTurnScore(w, isWhiteTurn);
+    }
+    if (batch.buffer[PBSIM_BUF_AI_POINTS])
+        ((int32_t*)batch.buffer[PBSIM_BUF_AI_POINTS])[i] = simAIPoint(w);
+    if (batch.buffer[PBSIM_BUF_STEPS])
+        ((int32_t*)batch.buffer[PBSIM_BUF_STEPS])[i] = steps;
+
+    if (!(flags & PBSIM_RUN_HITS_ONLY)) simSettle(w);
+    memcpy(balls, w.ball, sizeof(w.ball));
+}
+
+int pbSimRun(PbSimBatch* batch, int flags)
+{
+    if (!batch) return PBSIM_ERR_ARGUMENT;
+    if (!batch->buffer[PBSIM_BUF_BALLS] || !batch->buffer[PBSIM_BUF_SHOTS]) return PBSIM_ERR_NO_BUFFER;
+
+    // 잘못된 샷이 있으면 아무 판도 치지 않음
+    const PbSimShot* shots = (const PbSimShot*)batch->buffer[PBSIM_BUF_SHOTS];
+    for (int i = 0; i < batch->count; i++) {
+        if (shots[i].ball < 0 || shots[i].ball >= SIM_BALLS || !std::isfinite(shots[i].targetX) ||
+            !std::isfinite(shots[i].targetZ))
+            return PBSIM_ERR_BAD_SHOT;
+    }
+
+    try {
+        const PbSimBatch& b = *batch;
+        batch->pool->parallelFor(batch->count, [&b, flags](int i) { runOne(b, i, flags); });
+    }
+    catch (...) {
+        return PBSIM_ERR_INTERNAL;
+    }
+    return PBSIM_OK;
+}
+
+void pbSimStartBalls(PbSimBall* balls, int count)
+{
+    if (!balls) return;
+    SimWorld w;
+    simReset(w);
+    for (int i = 0; i < count; i++) memcpy(balls + (size_t)i * PBSIM_BALLS, w.ball, sizeof(w.ball));
+}
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: pocketballSim.h
+//
+// Desc: 물리 시뮬레이터를 C 에서 부르는 공유 라이브러리 (libpocketball_sim) 의 C ABI.
+//       C++ 바깥 (Python/numpy 등) 의 분석/학습 도구가 게임 화면 없이 샷을 한꺼번에 돌리는 용도.
+//       빌드 예) g++ -O2 -std=c++14 -shared -fPIC -fvisibility=hidden -pthread -DPBSIM_BUILD
+//                    pocketballSim.cpp billiardSim.cpp -o libpocketball_sim.so
+//                cl /O2 /EHsc /LD /DPBSIM_BUILD pocketballSim.cpp billiardSim.cpp /Fe:pocketball_sim.dll
+//
+//       배열은 모두 부르는 쪽이 잡은 연속 메모리이고 라이브러리는 그 자리에서 읽고 씀 (복사본 없음).
+//       pbSimSetBuffer 로 한 번 묶어 두면 값만 바꿔 가며 pbSimRun 을 다시 부를 수 있음.
+//
+//           PbSimBatch* b = pbSimCreate(n, -1);
+//           pbSimSetBuffer(b, PBSIM_BUF_BALLS, balls);   // PbSimBall [n][4], 시작 배치 (pbSimStartBalls)
+//           pbSimSetBuffer(b, PBSIM_BUF_SHOTS, shots);   // PbSimShot [n]
+//           pbSimSetBuffer(b, PBSIM_BUF_HITS, hits);     // uint8_t [n][4]
+//           pbSimRun(b, 0);                              // balls 는 멈춘 배치로 바뀜
+//           pbSimDestroy(b);
+//
+//       numpy 에서는 balls = np.zeros((n, 4, 4), np.float32) 처럼 C 순서 배열의 ctypes.data 를 넘김.
+//       구조체 배치와 값의 뜻은 PBSIM_VERSION 이 같은 동안 바뀌지 않음 (필드는 덧붙이지 않고
+//       새 버퍼 종류로 늘림).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __pocketballSimH__
+#define __pocketballSimH__
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  ifdef PBSIM_BUILD
+#    define PBSIM_API __declspec(dllexport)
+#  else
+#    define PBSIM_API __declspec(dllimport)
+#  endif
+#else
+#  define PBSIM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PBSIM_VERSION 1
+#define PBSIM_BALLS   4   // ball number 0: r, 1: r, 2: y, 3: w
+
+// 공 하나 (16 byte). 한 판 = PbSimBall [PBSIM_BALLS], 배치 전체 = [count][PBSIM_BALLS].
+typedef struct PbSimBall {
+    float x, z;
+    float vx, vz;
+} PbSimBall;
+
+// 샷 하나 (12 byte): ball 을 (targetX, targetZ) 쪽으로 그 거리만큼의 세기로 침 (VK_SPACE 와 같음).
+typedef struct PbSimShot {
+    int32_t ball;   // 2: 노란 공, 3: 흰 공
+    float   targetX, targetZ;
+} PbSimShot;
+
+// pbSimSetBuffer 의 종류. 길이는 모두 count 판 분량.
+enum {
+    PBSIM_BUF_BALLS = 0,     // PbSimBall [count][4]  읽고 씀 (필수). 친 뒤의 공 상태로 바뀜.
+    PBSIM_BUF_SHOTS = 1,     // PbSimShot [count]     읽기 (필수)
+    PBSIM_BUF_HITS = 2,      // uint8_t [count][4]    hit[i] 의 bit j: 공 i 와 공 j 가 닿음 (CSphere::hit)
+    PBSIM_BUF_SCORES = 3,    // int32_t [count]       친 공 기준 getScore (1 / 0 / -1, 빨간 공을 치면 0)
+    PBSIM_BUF_AI_POINTS = 4, // int32_t [count]       calculateAIPoint (노란 공 기준 Q-table 보상)
+    PBSIM_BUF_STEPS = 5,     // int32_t [count]       멈출 때 (HITS_ONLY 면 hit 가 정해질 때) 까지의 step 수
+    PBSIM_BUF_COUNT
+};
+
+// pbSimRun 의 flags
+enum {
+    PBSIM_RUN_HITS_ONLY = 1,   // hit 가 정해지면 끝냄 (simRunHits). 공은 아직 움직이는 중일 수 있음.
+};
+
+// 반환 값
+enum {
+    PBSIM_OK = 0,
+    PBSIM_ERR_ARGUMENT = -1,   // NULL batch, 없는 버퍼 종류
+    PBSIM_ERR_NO_BUFFER = -2,  // balls 나 shots 를 묶지 않음
+    PBSIM_ERR_BAD_SHOT = -3,   // shot.ball 이 0 ~ 3 이 아니거나 값이 유한하지 않음. 아무것도 바꾸지 않음.
+    PBSIM_ERR_INTERNAL = -4,   // 메모리/스레드 생성 실패
+};
+
+typedef struct PbSimBatch PbSimBatch;
+
+PBSIM_API int         pbSimVersion(void);   // 라이브러리의 PBSIM_VERSION
+PBSIM_API const char* pbSimErrorString(int code);
+
+// count 판짜리 배치. threads < 0 이면 (코어 수 - 1) 개의 worker + 부른 스레드, 0 이면 부른 스레드만.
+// 실패하면 NULL.
+PBSIM_API PbSimBatch* pbSimCreate(int count, int threads);
+PBSIM_API void        pbSimDestroy(PbSimBatch* batch);
+PBSIM_API int         pbSimCount(const PbSimBatch* batch);
+
+// 버퍼를 묶음 (NULL 이면 풂). 라이브러리는 포인터만 기억하므로 pbSimRun 동안 살아 있어야 함.
+PBSIM_API int pbSimSetBuffer(PbSimBatch* batch, int buffer, void* data);
+
+// 판마다 shots 의 샷을 쳐서 결과를 묶인 버퍼에 씀. 기본은 멈출 때까지 진행한 뒤 남은 느린 움직임도
+// 0 으로 정리 (simSettle) 해서, balls 가 곧 다음 샷 직전 배치. 판끼리는 독립이라 스레드로 나눠 돎.
+// 한 배치에서 동시에 두 번 부르면 안 됨 (배치가 다르면 괜찮음).
+PBSIM_API int pbSimRun(PbSimBatch* batch, int flags);
+
+// 시작 배치 (spherePos, 정지) 를 count 판에 씀
+PBSIM_API void pbSimStartBalls(PbSimBall* balls, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __pocketballSimH__
@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: policyTable.cpp
+//
+// Desc: 정책표 컴파일 및 메모리 맵 조회
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "policyTable.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const int POLICY_VERSION = 1;
+
+static int clampBin(int v) {
+    if (v < POLICY_BIN_MIN) return POLICY_BIN_MIN;
+    if (v >= POLICY_BIN_MIN + POLICY_BIN_COUNT) return POLICY_BIN_MIN + POLICY_BIN_COUNT - 1;
+    return v;
+}
+
+// -----------------------------------------------------------------------------
+// compile
+// -----------------------------------------------------------------------------
+
+int CompilePolicy(const std::vector<QEntry>& qTable, const char* path) {
+    const int N = POLICY_BIN_COUNT;
+
+    // 1. 엔트리를 (dx1, dx2) 칸별로 모음
+    std::vector<std::vector<int> > bucket(N * N);
+    for (int i = 0; i < (int)qTable.size(); i++) {
+        const State& s = qTable[i].state;
+        int a = s.dx1 - POLICY_BIN_MIN, b = s.dx2 - POLICY_BIN_MIN;
+        if (a < 0 || a >= N || b < 0 || b >= N) continue;
+        bucket[a * N + b].push_back(i);
+    }
+
+    // 2. 칸마다 ±1 이웃 중 평균 보상이 가장 높은 엔트리 (동점이면 테이블에서 먼저 나온 것)
+    std::vector<PolicyCell> cells(N * N);
+    int learned = 0;
+    for (int a = 0; a < N; a++) {
+        for (int b = 0; b < N; b++) {
+            int best = -1;
+            for (int da = -1; da <= 1; da++) {
+                for (int db = -1; db <= 1; db++) {
+                    int na = a + da, nb = b + db;
+                    if (na < 0 || na >= N || nb < 0 || nb >= N) continue;
+                    for (int idx : bucket[na * N + nb]) {
+                        if (best < 0 || qTable[idx].avgReward > qTable[best].avgReward ||
+                            (qTable[idx].avgReward == qTable[best].avgReward && idx < best))
+                            best = idx;
+                    }
+                }
+            }
+            PolicyCell& c = cells[a * N + b];
+            memset(&c, 0, sizeof(c));
+            if (best >= 0) {
+                c.tx = (signed char)qTable[best].state.tx;
+                c.tz = (signed char)qTable[best].state.tz;
+                c.flags = POLICY_LEARNED;
+                learned++;
+            }
+        }
+    }
+
+    // 3. 빈 칸은 가장 가까운 학습된 칸으로 채움 (multi-source BFS, 8 방향)
+    if (learned > 0) {
+        std::vector<int> queue;
+        queue.reserve(N * N);
+        for (int i = 0; i < N * N; i++)
+            if (cells[i].flags & POLICY_LEARNED) queue.push_back(i);
+        for (size_t head = 0; head < queue.size(); head++) {
+            int cur = queue[head];
+            int a = cur / N, b = cur % N;
+            for (int da = -1; da <= 1; da++) {
+                for (int db = -1; db <= 1; db++) {
+                    int na = a + da, nb = b + db;
+                    if (na < 0 || na >= N || nb < 0 || nb >= N) continue;
+                    PolicyCell& n = cells[na * N + nb];
+                    if (n.flags) continue;
+                    n.tx = cells[cur].tx;
+                    n.tz = cells[cur].tz;
+                    n.flags = POLICY_FILLED;
+                    queue.push_back(na * N + nb);
+                }
+            }
+        }
+    }
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return -1;
+    PolicyHeader h;
+    memcpy(h.magic, "PBPL", 4);
+    h.version = POLICY_VERSION;
+    h.binMin = POLICY_BIN_MIN;
+    h.binCount = N;
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1 &&
+        fwrite(&cells[0], sizeof(PolicyCell), cells.size(), fp) == cells.size();
+    ok = (fclose(fp) == 0) && ok;
+    return ok ? learned : -1;
+}
+
+// -----------------------------------------------------------------------------
+// CPolicyTable
+// -----------------------------------------------------------------------------
+
+CPolicyTable::CPolicyTable() : m_cells(NULL), m_view(NULL), m_viewSize(0)
+#ifdef _WIN32
+    , m_file(NULL), m_mapping(NULL)
+#endif
+{
+}
+
+CPolicyTable::~CPolicyTable() { close(); }
+
+bool CPolicyTable::open(const char* path) {
+    close();
+    size_t expect = sizeof(PolicyHeader) + sizeof(PolicyCell) * POLICY_BIN_COUNT * POLICY_BIN_COUNT;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    m_file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (size_t)size.QuadPart < expect) { close(); return false; }
+    m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m_mapping) { close(); return false; }
+    m_view = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_view) { close(); return false; }
+    m_viewSize = (size_t)size.QuadPart;
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < expect) { ::close(fd); return false; }
+    void* view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // 매핑은 fd 를 닫아도 유지됨
+    if (view == MAP_FAILED) return false;
+    m_view = view;
+    m_viewSize = (size_t)st.st_size;
+#endif
+
+    const PolicyHeader* h = (const PolicyHeader*)m_view;
+    if (memcmp(h->magic, "PBPL", 4) != 0 || h->version != POLICY_VERSION ||
+        h->binMin != POLICY_BIN_MIN || h->binCount != POLICY_BIN_COUNT) {
+        close();
+        return false;
+    }
+    m_cells = (const PolicyCell*)(h + 1);
+    return true;
+}
+
+void CPolicyTable::close() {
+    m_cells = NULL;
+#ifdef _WIN32
+    if (m_view) UnmapViewOfFile(m_view);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_mapping = m_file = NULL;
+#else
+    if (m_view) munmap(m_view, m_viewSize);
+#endif
+    m_view = NULL;
+    m_viewSize = 0;
+}
+
+bool CPolicyTable::lookup(int dx1, int dx2, int& tx, int& tz) const {
+    if (!m_cells) return false;
+    int a = clampBin(dx1) - POLICY_BIN_MIN;
+    int b = clampBin(dx2) - POLICY_BIN_MIN;
+    const PolicyCell& c = m_cells[a * POLICY_BIN_COUNT + b];
+    if (!c.flags) return false;   // 학습 데이터가 아예 없던 표
+    tx = c.tx;
+    tz = c.tz;
+    return true;
+}
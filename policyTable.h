@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: policyTable.h
+//
+// Desc: 학습된 Q-table 을 "상태 -> 가장 좋은 조준" 배열로 미리 계산해 둔 읽기 전용 정책표.
+//       AIFireYellowBall 이 비슷한 상태를 고르는 기준 (dx1, dx2 가 각각 ±1 이내) 과 같게
+//       (dx1, dx2) 칸마다 평균 보상이 가장 높은 엔트리의 tx, tz 를 저장하고,
+//       학습 데이터가 없는 칸은 가장 가까운 칸의 값으로 채움.
+//       파일은 메모리 맵으로 열어서 조회 한 번이 배열 접근 한 번.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __policyTableH__
+#define __policyTableH__
+
+#include "qTable.h"
+
+#define POLICY_FILE "ai_policy.bin"
+
+// bin() 결과의 범위. 테이블 안의 두 공 사이 x 거리는 9 - 2r 이하 -> |dx| <= 17
+const int POLICY_BIN_MIN = -18;
+const int POLICY_BIN_COUNT = 37;
+
+enum {
+    POLICY_LEARNED = 1,   // 이 칸 근처에 학습 데이터가 있었음
+    POLICY_FILLED = 2,    // 가장 가까운 학습된 칸에서 복사
+};
+
+struct PolicyCell {
+    signed char   tx, tz;   // QEntry.state.tx, tz 와 같은 단위 (0.5)
+    unsigned char flags;
+    unsigned char pad;
+};
+
+struct PolicyHeader {
+    char magic[4];      // "PBPL"
+    int  version;
+    int  binMin;
+    int  binCount;
+};
+
+// qTable 로부터 정책표를 만들어 path 에 저장. 학습된 칸 수 반환 (실패 시 -1)
+int CompilePolicy(const std::vector<QEntry>& qTable, const char* path = POLICY_FILE);
+
+class CPolicyTable {
+public:
+    CPolicyTable();
+    ~CPolicyTable();
+
+    bool open(const char* path = POLICY_FILE);
+    void close();
+    bool isOpen() const { return m_cells != NULL; }
+
+    // 상태 (dx1, dx2) 의 조준. 범위 밖이면 가장자리 칸을 씀. 표가 비었으면 false.
+    bool lookup(int dx1, int dx2, int& tx, int& tz) const;
+
+private:
+    const PolicyCell* m_cells;
+    void*             m_view;
+    size_t            m_viewSize;
+#ifdef _WIN32
+    void*             m_file;
+    void*             m_mapping;
+#endif
+};
+
+#endif // __policyTableH__
@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: qTable.cpp
+//
+// Desc: 노란공 AI 의 Q-learning 테이블 구현
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "qTable.h"
+#include "trace.h"
+#include "allocTrack.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+// lastUse 용 시계. 테이블마다 따로 둘 필요 없이 단조 증가만 하면 됨.
+static std::atomic<unsigned> s_useTick(0);
+
+int bin(float v, float step) {
+    // step 단위로 좌표를 정수화
+    return int(v / step);
+}
+
+int compareState(const State& a, const State& b) {
+    const int* x = &a.dx1;
+    const int* y = &b.dx1;
+    for (int i = 0; i < 8; i++) {
+        if (x[i] != y[i]) return x[i] < y[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+void UpdateQTable(std::vector<QEntry>& qTable, const State& s, float reward,
+    const QTableBudget& budget) {   // QTable 갱신 함수
+    TRACE_SCOPE("UpdateQTable");
+    for (auto& e : qTable) {
+        if (memcmp(&e.state, &s, sizeof(State)) == 0) {
+            // 기존 state 발견 → 업데이트
+            e.totalReward += reward;
+            e.count++;
+            e.avgReward = e.totalReward / e.count;
+            TouchQEntry(e);
+            return;
+        }
+    }
+
+    // 새로운 state 추가. 한도가 있으면 자리부터 만듦.
+    if (budget.maxBytes > 0) {
+        size_t capacity = budget.maxBytes / sizeof(QEntry);
+        if (qTable.size() + 1 > capacity) EvictQTable(qTable, budget);
+        if (qTable.capacity() < capacity) qTable.reserve(capacity);   // 이후로는 재할당 없음
+    }
+    QEntry entry;
+    entry.state = s;
+    entry.totalReward = reward;
+    entry.count = 1;
+    entry.avgReward = reward;
+    TouchQEntry(entry);
+    qTable.push_back(entry);
+    TRACE_COUNTER("qTable entries", qTable.size());
+}
+
+void TouchQEntry(QEntry& e) {
+    e.lastUse = ++s_useTick;
+}
+
+// a 가 b 보다 먼저 지워져야 하면 true
+static bool evictsBefore(const QEntry& a, const QEntry& b, QEvictPolicy policy) {
+    switch (policy) {
+    case QEVICT_LRU:
+        return a.lastUse < b.lastUse;
+    case QEVICT_REWARD:
+        if (a.avgReward != b.avgReward) return a.avgReward < b.avgReward;
+        return a.count < b.count;
+    case QEVICT_VISIT:
+    default:
+        if (a.count != b.count) return a.count < b.count;
+        return a.lastUse < b.lastUse;
+    }
+}
+
+size_t EvictQTable(std::vector<QEntry>& qTable, const QTableBudget& budget) {
+    if (budget.maxBytes == 0) return 0;
+    size_t capacity = budget.maxBytes / sizeof(QEntry);
+    if (qTable.size() < capacity) return 0;
+    if (capacity == 0) {
+        size_t n = qTable.size();
+        qTable.clear();
+        return n;
+    }
+
+    // 하나씩 지우면 매번 전체를 훑어야 하므로 keepRatio 까지 한 번에 줄임
+    float ratio = (budget.keepRatio > 0 && budget.keepRatio < 1) ? budget.keepRatio : 0.9f;
+    size_t keep = (size_t)(capacity * ratio);
+    if (keep >= capacity) keep = capacity - 1;
+    size_t drop = qTable.size() - keep;
+
+    // 지울 것들을 앞쪽 drop 개로 모은 뒤 제거 (순서는 유지할 필요 없음)
+    std::nth_element(qTable.begin(), qTable.begin() + drop, qTable.end(),
+        [&](const QEntry& a, const QEntry& b) { return evictsBefore(a, b, budget.policy); });
+    qTable.erase(qTable.begin(), qTable.begin() + drop);
+    return drop;
+}
+
+size_t CompactQTable(std::vector<QEntry>& qTable, int minCount, float maxDropReward,
+    const QTableBudget& budget) {
+    size_t before = qTable.size();
+    qTable.erase(std::remove_if(qTable.begin(), qTable.end(),
+        [&](const QEntry& e) { return e.count < minCount && e.avgReward <= maxDropReward; }),
+        qTable.end());
+    if (budget.maxBytes > 0 && qTable.size() * sizeof(QEntry) > budget.maxBytes) {
+        QTableBudget exact = budget;
+        exact.keepRatio = 0.999999f;   // 오프라인에서는 한도 직전까지 채움
+        EvictQTable(qTable, exact);
+    }
+    SortQTable(qTable);
+    qTable.shrink_to_fit();
+    return before - qTable.size();
+}
+
+void SortQTable(std::vector<QEntry>& qTable) {
+    std::sort(qTable.begin(), qTable.end(),
+        [](const QEntry& a, const QEntry& b) { return stateLess(a.state, b.state); });
+}
+
+// Parameter File Load/Save
+void SaveQTable(const std::vector<QEntry>& qTable, const char* path) {
+    TRACE_SCOPE("SaveQTable");
+    ALLOC_SCOPE("qtable io");
+    FILE* fp = fopen(path, "w");
+    if (!fp) return;
+    for (auto& e : qTable) {
+        fprintf(fp, "%d %d %d %d %d %d %d %d %f %d %f\n",
+            e.state.dx1, e.state.dz1,
+            e.state.dx2, e.state.dz2,
+            e.state.dxw, e.state.dzw,
+            e.state.tx, e.state.tz,
+            e.totalReward, e.count, e.avgReward);
+    }
+    fclose(fp);
+}
+
+void LoadQTable(std::vector<QEntry>& qTable, const char* path) {
+    TRACE_SCOPE("LoadQTable");
+    ALLOC_SCOPE("qtable io");
+    qTable.clear();
+    FILE* fp = fopen(path, "r");
+    if (!fp) return;
+
+    QEntry e;
+    while (fscanf(fp, "%d %d %d %d %d %d %d %d %f %d %f",
+        &e.state.dx1, &e.state.dz1,
+        &e.state.dx2, &e.state.dz2,
+        &e.state.dxw, &e.state.dzw,
+        &e.state.tx, &e.state.tz,
+        &e.totalReward, &e.count, &e.avgReward) == 11)
+    {
+        e.lastUse = 0;
+        qTable.push_back(e);
+    }
+    fclose(fp);
+}
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: qTable.h
+//
+// Desc: 노란공 AI 의 Q-learning 테이블 (상태/엔트리 정의, 갱신, 파일 입출력).
+//       ai_qtable.txt 한 줄 = QEntry 하나
+//       "dx1 dz1 dx2 dz2 dxw dzw tx tz totalReward count avgReward"
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __qTableH__
+#define __qTableH__
+
+#include "tableSpec.h"
+#include <cstddef>
+#include <vector>
+
+#define QTABLE_FILE "ai_qtable.txt"
+
+// 상대 좌표 기반 상태
+struct State {
+    int dx1, dz1; // red1 - yellow 상대 위치
+    int dx2, dz2; // red2 - yellow 상대 위치
+    int dxw, dzw; // white - yellow 상대 위치
+    int tx, tz; // 파란공 - yellow 상대 위치
+};
+
+// Q-learning 용 엔트리
+struct QEntry {
+    State state;        // 상태
+    float totalReward;  // 누적 보상
+    int count;          // 시도 횟수
+    float avgReward;    // 평균 보상
+    unsigned lastUse;   // 마지막으로 갱신/선택된 시점 (메모리에만 있음, 파일에는 저장 안 함)
+};
+
+// bounded mode 에서 넘친 엔트리를 고르는 기준
+enum QEvictPolicy {
+    QEVICT_VISIT,   // 시도 횟수가 적은 것부터 (같으면 오래된 것부터)
+    QEVICT_LRU,     // 가장 오래 안 쓰인 것부터
+    QEVICT_REWARD,  // 평균 보상이 낮은 것부터 (같으면 시도 횟수 적은 것부터)
+};
+
+// 테이블 메모리 한도. maxBytes == 0 이면 예전처럼 무제한.
+struct QTableBudget {
+    size_t       maxBytes;
+    QEvictPolicy policy;
+    float        keepRatio;   // 한도를 넘으면 한도 x keepRatio 개까지 한 번에 줄임
+};
+
+const QTableBudget QTABLE_UNBOUNDED = { 0, QEVICT_VISIT, 0.9f };
+
+// 테이블 규격의 stateBin (4구 테이블 0.5) 단위로 좌표를 정수화
+int bin(float v, float step = (float)CAROM_TABLE.stateBin);
+
+// State 사전식 비교 (dx1, dz1, ..., tz 순). 정렬된 shard 파일의 순서 기준.
+int compareState(const State& a, const State& b);
+inline bool stateLess(const State& a, const State& b) { return compareState(a, b) < 0; }
+
+void UpdateQTable(std::vector<QEntry>& qTable, const State& s, float reward,
+    const QTableBudget& budget = QTABLE_UNBOUNDED);   // QTable 갱신 함수
+void TouchQEntry(QEntry& e);   // AI 가 선택한 엔트리의 lastUse 갱신
+void SortQTable(std::vector<QEntry>& qTable);   // State 순으로 정렬
+
+// 한도를 넘었으면 policy 에 따라 가치가 낮은 엔트리를 지움. 지운 개수 반환.
+size_t EvictQTable(std::vector<QEntry>& qTable, const QTableBudget& budget);
+// 오프라인 정리: count < minCount 이면서 avgReward <= maxDropReward 인 엔트리를 지우고
+// budget 까지 줄인 뒤 State 순으로 정렬. 지운 개수 반환.
+size_t CompactQTable(std::vector<QEntry>& qTable, int minCount, float maxDropReward,
+    const QTableBudget& budget = QTABLE_UNBOUNDED);
+
+// Parameter File Load/Save
+void SaveQTable(const std::vector<QEntry>& qTable, const char* path = QTABLE_FILE);
+void LoadQTable(std::vector<QEntry>& qTable, const char* path = QTABLE_FILE);
+
+#endif // __qTableH__
@@ -0,0 +1,469 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: qTableShard.cpp
+//
+// Desc: Q-table shard 의 스트리밍 병렬 k-way merge
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "qTableShard.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <thread>
+
+#ifdef _WIN32
+#define fseek64 _fseeki64
+#define ftell64 _ftelli64
+#else
+#define fseek64 fseeko
+#define ftell64 ftello
+#endif
+
+// -----------------------------------------------------------------------------
+// 빠른 텍스트 변환 (fscanf/fprintf 대신, "%d" / "%f" 형식만 처리)
+// -----------------------------------------------------------------------------
+
+namespace {
+
+inline void skipSpace(const char*& p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r') p++;
+}
+
+inline bool parseInt(const char*& p, int& out) {
+    skipSpace(p);
+    bool neg = (*p == '-');
+    if (*p == '-' || *p == '+') p++;
+    if (*p < '0' || *p > '9') return false;
+    int v = 0;
+    while (*p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+    out = neg ? -v : v;
+    return true;
+}
+
+inline bool parseFloat(const char*& p, float& out) {
+    skipSpace(p);
+    bool neg = (*p == '-');
+    if (*p == '-' || *p == '+') p++;
+    if ((*p < '0' || *p > '9') && *p != '.') return false;
+    double v = 0;
+    while (*p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+    if (*p == '.') {
+        p++;
+        double scale = 1;
+        long long frac = 0;
+        while (*p >= '0' && *p <= '9') {
+            if (scale < 1e15) { frac = frac * 10 + (*p - '0'); scale *= 10; }
+            p++;
+        }
+        v += frac / scale;
+    }
+    out = (float)(neg ? -v : v);
+    return true;
+}
+
+inline char* formatInt(char* p, long long v) {
+    char tmp[24];
+    int n = 0;
+    bool neg = v < 0;
+    unsigned long long u = neg ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    do { tmp[n++] = (char)('0' + u % 10); u /= 10; } while (u);
+    if (neg) *p++ = '-';
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+// printf("%f") 와 같은 소수점 6 자리 고정 형식
+inline char* formatFloat(char* p, double v) {
+    if (!(v > -9e12 && v < 9e12)) return p + sprintf(p, "%f", v);
+    bool neg = v < 0;
+    long long q = (long long)((neg ? -v : v) * 1e6 + 0.5);
+    if (neg && q != 0) *p++ = '-';
+    p = formatInt(p, q / 1000000);
+    *p++ = '.';
+    long long frac = q % 1000000;
+    for (long long d = 100000; d > 0; d /= 10) *p++ = (char)('0' + (frac / d) % 10);
+    return p;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// QShardReader
+// -----------------------------------------------------------------------------
+
+QShardReader::QShardReader()
+    : m_fp(NULL), m_pos(0), m_len(0), m_base(0), m_offset(0), m_eof(true), m_size(0), m_pendingOffset(0),
+      m_hasPending(false) {}
+
+QShardReader::~QShardReader() { close(); }
+
+bool QShardReader::open(const char* path, size_t bufSize) {
+    close();
+    m_fp = fopen(path, "rb");
+    if (!m_fp) return false;
+
+    fseek64(m_fp, 0, SEEK_END);
+    m_size = (long long)ftell64(m_fp);
+    fseek64(m_fp, 0, SEEK_SET);
+
+    if (bufSize < 4096) bufSize = 4096;
+    m_buf.resize(bufSize + 1);   // 마지막 한 칸은 '\0' 용
+    m_pos = m_len = 0;
+    m_base = 0;
+    m_eof = false;
+    return true;
+}
+
+void QShardReader::close() {
+    if (m_fp) {
+        fclose(m_fp);
+        m_fp = NULL;
+    }
+    m_pos = m_len = 0;
+    m_eof = true;
+    m_hasPending = false;
+}
+
+bool QShardReader::fill() {
+    // 남은 부분을 앞으로 당기고 뒤를 채움
+    if (m_pos > 0) {
+        memmove(&m_buf[0], &m_buf[m_pos], m_len - m_pos);
+        m_len -= m_pos;
+        m_base += m_pos;
+        m_pos = 0;
+    }
+    size_t cap = m_buf.size() - 1;
+    if (m_len == cap) return false;   // 한 줄이 버퍼보다 긺
+    size_t n = fread(&m_buf[m_len], 1, cap - m_len, m_fp);
+    if (n == 0) m_eof = true;
+    m_len += n;
+    return n > 0;
+}
+
+bool QShardReader::seek(long long offset) {
+    if (!m_fp) return false;
+    m_pos = m_len = 0;
+    m_eof = false;
+    m_hasPending = false;
+    if (offset <= 0) {
+        fseek64(m_fp, 0, SEEK_SET);
+        m_base = 0;
+        return true;
+    }
+    // offset-1 부터 읽어서 줄 끝까지 버림 -> offset 이 줄 시작이면 그대로 그 줄부터
+    fseek64(m_fp, offset - 1, SEEK_SET);
+    m_base = offset - 1;
+    for (;;) {
+        char* nl = (char*)memchr(&m_buf[m_pos], '\n', m_len - m_pos);
+        if (nl) {
+            m_pos = (nl - &m_buf[0]) + 1;
+            return true;
+        }
+        m_pos = m_len;
+        if (!fill()) return false;
+    }
+}
+
+bool QShardReader::seekLowerBound(const State& s) {
+    long long lo = 0, hi = m_size;
+    QEntry e;
+    // 줄 단위가 아닌 바이트 단위 이진 탐색. hi 이후 첫 줄은 항상 s 이상.
+    while (hi - lo > 4096) {
+        long long mid = lo + (hi - lo) / 2;
+        if (!seek(mid) || !next(e) || !stateLess(e.state, s)) hi = mid;
+        else lo = mid;
+    }
+    if (!seek(lo)) return false;
+
+    // 남은 구간은 순차적으로 건너뜀
+    while (next(e)) {
+        if (!stateLess(e.state, s)) {
+            m_pending = e;   // 방금 읽은 엔트리는 다음 next() 에서 돌려줌
+            m_pendingOffset = m_offset;
+            m_hasPending = true;
+            break;
+        }
+    }
+    return true;
+}
+
+bool QShardReader::next(QEntry& e) {
+    if (!m_fp) return false;
+    if (m_hasPending) {
+        e = m_pending;
+        m_offset = m_pendingOffset;
+        m_hasPending = false;
+        return true;
+    }
+    for (;;) {
+        char* line = &m_buf[m_pos];
+        char* nl = (char*)memchr(line, '\n', m_len - m_pos);
+        if (!nl) {
+            if (!m_eof && fill()) continue;
+            if (m_pos >= m_len) return false;
+            nl = &m_buf[m_len];   // 마지막 줄에 개행이 없는 경우
+        }
+        *nl = '\0';
+        size_t lineEnd = (nl - &m_buf[0]) + 1;
+
+        const char* p = line;
+        int* fields = &e.state.dx1;
+        bool ok = true;
+        for (int i = 0; i < 8 && ok; i++) ok = parseInt(p, fields[i]);
+        ok = ok && parseFloat(p, e.totalReward) && parseInt(p, e.count) && parseFloat(p, e.avgReward);
+        e.lastUse = 0;
+
+        long long lineOffset = m_base + (long long)m_pos;
+        m_pos = lineEnd < m_len ? lineEnd : m_len;
+        if (ok) {
+            m_offset = lineOffset;
+            return true;
+        }
+        // 빈 줄/깨진 줄은 건너뜀
+    }
+}
+
+// -----------------------------------------------------------------------------
+// merge
+// -----------------------------------------------------------------------------
+
+namespace {
+
+struct HeapItem {
+    QEntry entry;
+    int    shard;
+};
+
+struct HeapGreater {
+    bool operator()(const HeapItem& a, const HeapItem& b) const {
+        return stateLess(b.entry.state, a.entry.state);
+    }
+};
+
+struct Partition {
+    bool        hasLo, hasHi;
+    State       lo, hi;     // [lo, hi)
+    std::string outPath;
+    long long   entriesIn;
+    long long   entriesOut;
+    bool        ok;
+    int         unsorted;   // 정렬 안 된 shard 번호 (없으면 -1)
+    // shard 마다 이 구간에서 처음 읽은 엔트리와 hi 에 닿아 멈춘 엔트리의 파일 위치 (없으면 SPAN_END).
+    // 정렬된 shard 면 앞 구간의 end 가 다음 구간의 begin 과 같음.
+    std::vector<long long> begin, end;
+};
+
+const long long SPAN_END = LLONG_MAX;
+
+void writeEntry(FILE* fp, const State& s, double total, long long count) {
+    // 파일의 count 는 int (LoadQTable 의 %d). 넘치면 평균을 유지한 채 자름.
+    if (count > INT_MAX) {
+        total = total / count * INT_MAX;
+        count = INT_MAX;
+    }
+    char line[256];
+    char* p = line;
+    const int* fields = &s.dx1;
+    for (int i = 0; i < 8; i++) {
+        p = formatInt(p, fields[i]);
+        *p++ = ' ';
+    }
+    p = formatFloat(p, (float)total);
+    *p++ = ' ';
+    p = formatInt(p, count);
+    *p++ = ' ';
+    p = formatFloat(p, (float)(total / count));
+    *p++ = '\n';
+    fwrite(line, 1, p - line, fp);
+}
+
+void mergePartition(const std::vector<std::string>& shards, size_t bufSize, Partition& part) {
+    part.ok = false;
+    part.unsorted = -1;
+    part.entriesIn = part.entriesOut = 0;
+    part.begin.assign(shards.size(), SPAN_END);
+    part.end.assign(shards.size(), SPAN_END);
+
+    FILE* out = fopen(part.outPath.c_str(), "wb");
+    if (!out) return;
+    std::vector<char> outBuf(1 << 20);
+    setvbuf(out, &outBuf[0], _IOFBF, outBuf.size());
+
+    std::vector<QShardReader> readers(shards.size());
+    std::priority_queue<HeapItem, std::vector<HeapItem>, HeapGreater> heap;
+
+    for (size_t i = 0; i < shards.size(); i++) {
+        if (!readers[i].open(shards[i].c_str(), bufSize)) { fclose(out); return; }
+        if (part.hasLo && !readers[i].seekLowerBound(part.lo)) continue;
+        HeapItem item;
+        item.shard = (int)i;
+        if (readers[i].next(item.entry)) {
+            part.begin[i] = readers[i].offset();
+            heap.push(item);
+        }
+    }
+
+    bool hasCur = false;
+    State cur;
+    double total = 0;
+    long long count = 0;
+
+    while (!heap.empty()) {
+        HeapItem item = heap.top();
+        heap.pop();
+        if (part.hasHi && !stateLess(item.entry.state, part.hi)) {
+            part.end[item.shard] = readers[item.shard].offset();
+            readers[item.shard].close();   // 이 shard 는 이 구간에서 끝
+            continue;
+        }
+        part.entriesIn++;
+
+        if (hasCur && compareState(cur, item.entry.state) == 0) {
+            total += item.entry.totalReward;
+            count += item.entry.count;
+        }
+        else {
+            if (hasCur) {
+                writeEntry(out, cur, total, count);
+                part.entriesOut++;
+            }
+            cur = item.entry.state;
+            total = item.entry.totalReward;
+            count = item.entry.count;
+            hasCur = true;
+        }
+
+        State prev = item.entry.state;
+        if (readers[item.shard].next(item.entry)) {
+            if (stateLess(item.entry.state, prev)) {
+                // 정렬 안 된 shard (같은 State 가 이어진 것은 위에서 더해짐)
+                part.unsorted = item.shard;
+                fclose(out);
+                return;
+            }
+            heap.push(item);
+        }
+    }
+    if (hasCur) {
+        writeEntry(out, cur, total, count);
+        part.entriesOut++;
+    }
+    part.ok = (fclose(out) == 0);
+}
+
+// 가장 큰 shard 를 균등한 바이트 위치에서 샘플링해 구간 경계를 정함
+std::vector<State> choosePivots(const std::vector<std::string>& shards, int numParts) {
+    std::vector<State> pivots;
+    size_t largest = 0;
+    long long largestSize = -1;
+    for (size_t i = 0; i < shards.size(); i++) {
+        QShardReader r;
+        if (r.open(shards[i].c_str(), 4096) && r.size() > largestSize) {
+            largestSize = r.size();
+            largest = i;
+        }
+    }
+    QShardReader r;
+    if (numParts <= 1 || !r.open(shards[largest].c_str(), 4096)) return pivots;
+
+    QEntry e;
+    for (int i = 1; i < numParts; i++) {
+        if (r.seek(largestSize * i / numParts) && r.next(e)) pivots.push_back(e.state);
+    }
+    std::sort(pivots.begin(), pivots.end(), stateLess);
+    pivots.erase(std::unique(pivots.begin(), pivots.end(),
+        [](const State& a, const State& b) { return compareState(a, b) == 0; }), pivots.end());
+    return pivots;
+}
+
+bool appendFile(FILE* out, const char* path, std::vector<char>& buf) {
+    FILE* in = fopen(path, "rb");
+    if (!in) return false;
+    size_t n;
+    while ((n = fread(&buf[0], 1, buf.size(), in)) > 0) {
+        if (fwrite(&buf[0], 1, n, out) != n) { fclose(in); return false; }
+    }
+    fclose(in);
+    return true;
+}
+
+} // namespace
+
+bool MergeQTableShards(const std::vector<std::string>& shards, const char* outPath,
+    int numThreads, size_t memBudget, ShardMergeStats* stats)
+{
+    if (shards.empty()) return false;
+    if (numThreads < 1) numThreads = 1;
+
+    std::vector<State> pivots = choosePivots(shards, numThreads);
+    int numParts = (int)pivots.size() + 1;
+
+    // reader 버퍼: 전체 예산을 (구간 수 x shard 수) 로 나눔
+    size_t bufSize = memBudget / ((size_t)numParts * shards.size());
+    if (bufSize > ((size_t)1 << 20)) bufSize = (size_t)1 << 20;
+
+    std::vector<Partition> parts(numParts);
+    for (int i = 0; i < numParts; i++) {
+        parts[i].hasLo = (i > 0);
+        parts[i].hasHi = (i < numParts - 1);
+        if (parts[i].hasLo) parts[i].lo = pivots[i - 1];
+        if (parts[i].hasHi) parts[i].hi = pivots[i];
+        parts[i].outPath = numParts == 1 ? std::string(outPath)
+            : std::string(outPath) + ".part" + std::to_string(i);
+    }
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < numParts; i++)
+        workers.emplace_back(mergePartition, std::cref(shards), bufSize, std::ref(parts[i]));
+    mergePartition(shards, bufSize, parts[0]);
+    for (auto& w : workers) w.join();
+
+    bool ok = true;
+    for (auto& p : parts) ok = ok && p.ok;
+
+    // 구간마다 읽은 범위가 shard 를 빈틈없이 이어 덮는지. 정렬 안 된 shard 는 seekLowerBound 가
+    // 엉뚱한 곳에서 시작하거나 hi 에서 일찍 멈춰서, 내림차순을 만나지 않고도 줄을 빠뜨릴 수 있음.
+    std::vector<int> unsorted;
+    for (auto& p : parts) {
+        if (p.unsorted >= 0) unsorted.push_back(p.unsorted);
+    }
+    if (ok) {
+        for (size_t k = 0; k < shards.size(); k++) {
+            for (int i = 0; i + 1 < numParts; i++) {
+                if (parts[i].end[k] != parts[i + 1].begin[k]) {
+                    unsorted.push_back((int)k);
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    // 구간별 결과를 순서대로 이어붙임
+    if (ok && numParts > 1) {
+        FILE* out = fopen(outPath, "wb");
+        std::vector<char> buf(1 << 20);
+        ok = (out != NULL);
+        for (int i = 0; ok && i < numParts; i++) ok = appendFile(out, parts[i].outPath.c_str(), buf);
+        if (out && fclose(out) != 0) ok = false;
+    }
+    if (numParts > 1) {
+        for (auto& p : parts) remove(p.outPath.c_str());
+    }
+
+    if (stats) {
+        stats->entriesIn = stats->entriesOut = 0;
+        stats->partitions = numParts;
+        for (auto& p : parts) {
+            stats->entriesIn += p.entriesIn;
+            stats->entriesOut += p.entriesOut;
+        }
+        std::sort(unsorted.begin(), unsorted.end());
+        unsorted.erase(std::unique(unsorted.begin(), unsorted.end()), unsorted.end());
+        stats->unsorted = unsorted;
+    }
+    return ok;
+}
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: qTableShard.h
+//
+// Desc: 여러 trainer 가 각자 저장한 Q-table shard (ai_qtable.txt 형식) 를
+//       하나의 master 테이블로 합치는 기능.
+//       shard 는 State 순으로 정렬되어 있어야 하며 (SortQTable 후 SaveQTable),
+//       같은 State 끼리 (다른 shard 든 한 shard 안에서 이어진 것이든) totalReward / count 를
+//       더하고 avgReward 를 다시 계산함. count 는 int 를 넘지 않게 자름 (평균은 유지).
+//       trainer 의 shard 는 그 trainer 가 처음부터 배운 것을 모두 담으므로 (-shard 로 이어서 학습),
+//       master 는 매번 모든 shard 로 새로 만들고 이전 master 는 넣지 않음 (넣으면 두 번 셈).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __qTableShardH__
+#define __qTableShardH__
+
+#include "qTable.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// shard 파일을 순서대로 읽는 스트리밍 reader (버퍼 크기만큼만 메모리 사용)
+class QShardReader {
+public:
+    QShardReader();
+    ~QShardReader();
+
+    bool open(const char* path, size_t bufSize = 1 << 16);
+    void close();
+
+    // offset 이후의 첫 번째 줄부터 읽도록 이동 (offset == 0 이면 파일 처음)
+    bool seek(long long offset);
+    // offset 이후 처음으로 state >= s 인 엔트리 위치로 이동 (이진 탐색)
+    bool seekLowerBound(const State& s);
+
+    bool next(QEntry& e);
+    long long size() const { return m_size; }
+    // 마지막으로 next() 가 돌려준 엔트리 줄의 파일 위치
+    long long offset() const { return m_offset; }
+
+private:
+    bool fill();
+
+    FILE*             m_fp;
+    std::vector<char> m_buf;
+    size_t            m_pos, m_len;
+    long long         m_base;     // m_buf[0] 의 파일 위치
+    long long         m_offset;
+    bool              m_eof;
+    long long         m_size;
+    QEntry            m_pending;
+    long long         m_pendingOffset;
+    bool              m_hasPending;
+};
+
+struct ShardMergeStats {
+    long long entriesIn;    // 읽은 엔트리 수 (모든 shard 합)
+    long long entriesOut;   // 합쳐진 master 엔트리 수
+    int       partitions;   // 병렬로 나눈 구간 수
+    std::vector<int> unsorted;   // 정렬 안 된 shard 번호 (이때 merge 는 실패)
+};
+
+// 정렬된 shard 들을 k-way merge 해서 outPath 에 저장.
+// State 공간을 numThreads 개 구간으로 나눠 구간마다 스레드 하나가 처리하고,
+// memBudget 바이트 안에서 reader 버퍼 크기를 정함.
+// 구간마다 shard 에서 읽은 범위가 파일을 빈틈없이 이어 덮지 않으면 (= 정렬 안 됨) 실패하고
+// 그 shard 를 stats->unsorted 에 넣음. 정렬 여부를 따로 한 번 더 읽어서 검사하지 않음.
+bool MergeQTableShards(const std::vector<std::string>& shards, const char* outPath,
+    int numThreads, size_t memBudget = (size_t)256 << 20, ShardMergeStats* stats = NULL);
+
+#endif // __qTableShardH__
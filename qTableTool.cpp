@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: qTableTool.cpp
+//
+// Desc: Q-table 오프라인 관리용 커맨드라인 도구 (게임과 별도 실행 파일).
+//       빌드 예) cl /O2 /EHsc qTableTool.cpp qTable.cpp qTableShard.cpp policyTable.cpp neuralPolicy.cpp
+//                g++ -O2 -std=c++14 -pthread qTableTool.cpp qTable.cpp qTableShard.cpp policyTable.cpp neuralPolicy.cpp
+//
+//  qTableTool merge -o master.txt [-j threads] [-mem MB] shard1.txt shard2.txt ...
+//      trainer 들이 저장한 shard 들을 합쳐 master 생성. shard 는 그 trainer 가 처음부터 배운 것을
+//      모두 담고 있으므로 이전 master 는 넣지 않고 매번 모든 shard 로 새로 만듦 (넣으면 두 번 셈).
+//      merge 중에 정렬 안 된 shard (예전 방식의 ai_qtable.txt 등) 가 나오면 그 shard 만
+//      정렬본 (<shard>.sorted) 으로 바꿔 다시 merge.
+//  qTableTool sort in.txt out.txt
+//      테이블을 State 순으로 정렬해서 저장.
+//  qTableTool compact in.txt out.txt [-min N] [-drop R] [-mb MB] [-policy visit|lru|reward]
+//      시도 횟수 N 미만이면서 평균 보상 R 이하인 엔트리 (기본: 한 번 해보고 -1 받은 것) 를
+//      지우고, -mb 가 있으면 그 크기까지 policy 기준으로 더 줄임.
+//  qTableTool compile in.txt [out.bin]
+//      학습 끈 상태 (-nolearn) 의 AI 가 쓰는 정책표 (기본 ai_policy.bin) 생성.
+//  qTableTool train-mlp [out.bin] [-q table.txt] [-replay replay.txt]... [-epochs N] [-seed S]
+//      Q-table 과 replay 로그로 MLP 정책 (기본 ai_policy_mlp.bin, 게임에서 -mlp) 학습.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "qTable.h"
+#include "qTableShard.h"
+#include "policyTable.h"
+#include "neuralPolicy.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+
+static void usage() {
+    fprintf(stderr,
+        "usage:\n"
+        "  qTableTool merge -o <out> [-j threads] [-mem MB] <shard>...\n"
+        "  qTableTool sort <in> <out>\n"
+        "  qTableTool compact <in> <out> [-min N] [-drop R] [-mb MB] [-policy visit|lru|reward]\n"
+        "  qTableTool compile <in> [out]\n"
+        "  qTableTool train-mlp [out] [-q table] [-replay file]... [-epochs N] [-seed S]\n");
+}
+
+// 표기가 달라도 (./x, 절대 경로, 링크) 같은 파일이면 true
+static bool sameFile(const char* a, const char* b) {
+#ifdef _WIN32
+    char fullA[_MAX_PATH], fullB[_MAX_PATH];
+    return _fullpath(fullA, a, sizeof(fullA)) && _fullpath(fullB, b, sizeof(fullB)) && !_stricmp(fullA, fullB);
+#else
+    struct stat sa, sb;
+    return stat(a, &sa) == 0 && stat(b, &sb) == 0 && sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+#endif
+}
+
+static bool parsePolicy(const char* name, QEvictPolicy& policy) {
+    if (!strcmp(name, "visit")) policy = QEVICT_VISIT;
+    else if (!strcmp(name, "lru")) policy = QEVICT_LRU;
+    else if (!strcmp(name, "reward")) policy = QEVICT_REWARD;
+    else return false;
+    return true;
+}
+
+static int cmdSort(int argc, char** argv) {
+    if (argc != 2) { usage(); return 1; }
+    std::vector<QEntry> table;
+    LoadQTable(table, argv[0]);
+    SortQTable(table);
+    SaveQTable(table, argv[1]);
+    printf("%d entries sorted -> %s\n", (int)table.size(), argv[1]);
+    return 0;
+}
+
+static int cmdCompact(int argc, char** argv) {
+    if (argc < 2) { usage(); return 1; }
+    int minCount = 2;
+    float dropReward = -1.0f;
+    QTableBudget budget = QTABLE_UNBOUNDED;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "-min") && i + 1 < argc) minCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-drop") && i + 1 < argc) dropReward = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "-mb") && i + 1 < argc) budget.maxBytes = (size_t)(atof(argv[++i]) * (1 << 20));
+        else if (!strcmp(argv[i], "-policy") && i + 1 < argc && parsePolicy(argv[i + 1], budget.policy)) i++;
+        else { usage(); return 1; }
+    }
+
+    std::vector<QEntry> table;
+    LoadQTable(table, argv[0]);
+    size_t before = table.size();
+    size_t removed = CompactQTable(table, minCount, dropReward, budget);
+    SaveQTable(table, argv[1]);
+    printf("%d -> %d entries (%d removed) -> %s\n",
+        (int)before, (int)table.size(), (int)removed, argv[1]);
+    return 0;
+}
+
+static int cmdCompile(int argc, char** argv) {
+    if (argc < 1 || argc > 2) { usage(); return 1; }
+    const char* outPath = argc == 2 ? argv[1] : POLICY_FILE;
+    std::vector<QEntry> table;
+    LoadQTable(table, argv[0]);
+    int learned = CompilePolicy(table, outPath);
+    if (learned < 0) {
+        fprintf(stderr, "cannot write %s\n", outPath);
+        return 1;
+    }
+    printf("%d entries -> %d/%d learned cells -> %s\n", (int)table.size(), learned,
+        POLICY_BIN_COUNT * POLICY_BIN_COUNT, outPath);
+    return 0;
+}
+
+static int cmdTrainMLP(int argc, char** argv) {
+    const char* outPath = MLP_FILE;
+    const char* tablePath = NULL;
+    std::vector<const char*> replays;
+    int epochs = 30;
+    unsigned seed = 1;
+    for (int i = 0; i < argc; i++) {
+        if (!strcmp(argv[i], "-q") && i + 1 < argc) tablePath = argv[++i];
+        else if (!strcmp(argv[i], "-replay") && i + 1 < argc) replays.push_back(argv[++i]);
+        else if (!strcmp(argv[i], "-epochs") && i + 1 < argc) epochs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-seed") && i + 1 < argc) seed = (unsigned)atoi(argv[++i]);
+        else if (argv[i][0] != '-') outPath = argv[i];
+        else { usage(); return 1; }
+    }
+    if (!tablePath && replays.empty()) tablePath = QTABLE_FILE;
+
+    std::vector<PolicySample> samples;
+    if (tablePath) {
+        std::vector<QEntry> table;
+        LoadQTable(table, tablePath);
+        AppendQTableSamples(table, samples);
+    }
+    for (auto path : replays) {
+        if (!LoadReplaySamples(path, samples)) fprintf(stderr, "cannot read %s\n", path);
+    }
+    if (samples.empty()) {
+        fprintf(stderr, "no training samples\n");
+        return 1;
+    }
+
+    CNeuralPolicy policy;
+    float loss = TrainNeuralPolicy(policy, samples, epochs, seed, true);
+    if (!policy.save(outPath)) {
+        fprintf(stderr, "cannot write %s\n", outPath);
+        return 1;
+    }
+    printf("%d samples, loss %.4f, %d bytes of weights -> %s\n",
+        (int)samples.size(), loss, (int)sizeof(MLPWeights), outPath);
+    return 0;
+}
+
+static int cmdMerge(int argc, char** argv) {
+    const char* outPath = NULL;
+    int threads = (int)std::thread::hardware_concurrency();
+    size_t memMB = 256;
+    std::vector<std::string> shards;
+
+    for (int i = 0; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) outPath = argv[++i];
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-mem") && i + 1 < argc) memMB = (size_t)atoi(argv[++i]);
+        else shards.push_back(argv[i]);
+    }
+    if (!outPath || shards.empty()) { usage(); return 1; }
+    if (threads < 1) threads = 1;
+
+    for (auto& path : shards) {
+        if (sameFile(path.c_str(), outPath)) {
+            fprintf(stderr, "%s is both input and output (shards are cumulative; merge them without the old master)\n",
+                outPath);
+            return 1;
+        }
+    }
+
+#ifdef _WIN32
+    _setmaxstdio(8192);   // shard 수 x 스레드 수 만큼 파일을 동시에 엶
+#endif
+
+    auto t0 = std::chrono::steady_clock::now();
+    ShardMergeStats stats;
+    std::vector<std::string> sortedTemps;
+    bool ok;
+    for (;;) {
+        ok = MergeQTableShards(shards, outPath, threads, memMB << 20, &stats);
+        if (ok || stats.unsorted.empty()) break;
+        // 정렬 안 된 shard 는 정렬본으로 바꾸고 다시 (보통 shard 는 저장할 때 정렬되어 있음)
+        for (int i : stats.unsorted) {
+            fprintf(stderr, "shard not sorted, sorting: %s\n", shards[i].c_str());
+            std::vector<QEntry> table;
+            LoadQTable(table, shards[i].c_str());
+            SortQTable(table);
+            shards[i] += ".sorted";
+            SaveQTable(table, shards[i].c_str());
+            sortedTemps.push_back(shards[i]);
+        }
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    for (auto& path : sortedTemps) remove(path.c_str());
+
+    if (!ok) {
+        fprintf(stderr, "merge failed\n");
+        return 1;
+    }
+    printf("%d shards, %lld entries -> %lld states (%d partitions, %.2f s)\n",
+        (int)shards.size(), stats.entriesIn, stats.entriesOut, stats.partitions, sec);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { usage(); return 1; }
+    if (!strcmp(argv[1], "merge")) return cmdMerge(argc - 2, argv + 2);
+    if (!strcmp(argv[1], "sort")) return cmdSort(argc - 2, argv + 2);
+    if (!strcmp(argv[1], "compact")) return cmdCompact(argc - 2, argv + 2);
+    if (!strcmp(argv[1], "compile")) return cmdCompile(argc - 2, argv + 2);
+    if (!strcmp(argv[1], "train-mlp")) return cmdTrainMLP(argc - 2, argv + 2);
+    usage();
+    return 1;
+}
@@ -0,0 +1,267 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: rayCaster.cpp
+//
+// Desc: 조준 후보용 batch 광선 검사 (AVX2 + 한 광선씩)
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rayCaster.h"
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define RAY_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define RAY_AVX2_TARGET
+#else
+#define RAY_AVX2_TARGET __attribute__((target("avx2")))   // FMA 는 켜지 않음 (한 광선씩과 같은 결과)
+#endif
+#endif
+
+static const float RAY_X_MAX = (float)CAROM_TABLE.xMax();
+static const float RAY_Z_MAX = (float)CAROM_TABLE.zMax();
+static const float RAY_TOUCH = (float)((2 * SIM_RADIUS) * (2 * SIM_RADIUS));
+static const float RAY_INF = 1e30f;
+
+// 부딪힐 수 있는 다른 공들
+static int otherBalls(const SimWorld& w, int shooter, float* cx, float* cz, int* id)
+{
+    int m = 0;
+    for (int j = 0; j < SIM_BALLS; j++) {
+        if (j == shooter) continue;
+        cx[m] = w.ball[j].x;
+        cz[m] = w.ball[j].z;
+        id[m] = j;
+        m++;
+    }
+    return m;
+}
+
+static void castOne(float px, float pz, float dx, float dz, const float* cx, const float* cz,
+                    const int* id, int m, float maxDistance, int maxBounces, RayHit& out)
+{
+    float dist = 0;
+    int bounces = 0;
+    for (;;) {
+        float remaining = maxDistance - dist;
+
+        // 공: 중심끼리 2R 안으로 들어오는 첫 t (이미 붙어 있으면 0)
+        float bestT = remaining;
+        int   best = -1;
+        for (int j = 0; j < m; j++) {
+            float mx = px - cx[j], mz = pz - cz[j];
+            float b = mx * dx + mz * dz;
+            float c = mx * mx + mz * mz - RAY_TOUCH;
+            float disc = b * b - c;
+            float t = RAY_INF;
+            if (b < 0 && disc >= 0) {
+                t = -b - sqrtf(disc);
+                if (t < 0) t = 0;
+            }
+            if (c <= 0) t = 0;
+            if (t < bestT) {
+                bestT = t;
+                best = j;
+            }
+        }
+
+        // 쿠션
+        float tx = dx > 0 ? (RAY_X_MAX - px) / dx : dx < 0 ? (-RAY_X_MAX - px) / dx : RAY_INF;
+        float tz = dz > 0 ? (RAY_Z_MAX - pz) / dz : dz < 0 ? (-RAY_Z_MAX - pz) / dz : RAY_INF;
+        float tw = tx < tz ? tx : tz;
+
+        if (best >= 0 && bestT <= tw) {
+            out.ball = id[best];
+            out.bounces = bounces;
+            out.distance = dist + bestT;
+            return;
+        }
+        if (tw >= remaining) {
+            out.ball = -1;
+            out.bounces = bounces;
+            out.distance = maxDistance;
+            return;
+        }
+
+        px = px + dx * tw;
+        pz = pz + dz * tw;
+        dist = dist + tw;
+        if (tx <= tw) dx = -dx;
+        if (tz <= tw) dz = -dz;
+        bounces++;
+        if (bounces > maxBounces) {
+            out.ball = -1;
+            out.bounces = bounces;
+            out.distance = dist;
+            return;
+        }
+    }
+}
+
+void castRaysScalar(const SimWorld& w, int shooter, const float* dirX, const float* dirZ, int n,
+                    float maxDistance, int maxBounces, RayHit* out)
+{
+    float cx[SIM_BALLS], cz[SIM_BALLS];
+    int id[SIM_BALLS];
+    int m = otherBalls(w, shooter, cx, cz, id);
+    const SimBall& s = w.ball[shooter];
+    for (int i = 0; i < n; i++)
+        castOne(s.x, s.z, dirX[i], dirZ[i], cx, cz, id, m, maxDistance, maxBounces, out[i]);
+}
+
+#ifdef RAY_X86
+
+// castOne 과 같은 계산을 광선 8 개에 대해. 끝난 lane 은 active 에서 빠짐.
+RAY_AVX2_TARGET
+static int castRaysAVX2(const SimWorld& w, int shooter, const float* dirX, const float* dirZ, int n,
+                        float maxDistance, int maxBounces, RayHit* out)
+{
+    float cx[SIM_BALLS], cz[SIM_BALLS];
+    int id[SIM_BALLS];
+    int m = otherBalls(w, shooter, cx, cz, id);
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 inf = _mm256_set1_ps(RAY_INF);
+    const __m256 touch = _mm256_set1_ps(RAY_TOUCH);
+    const __m256 xMax = _mm256_set1_ps(RAY_X_MAX), xMin = _mm256_set1_ps(-RAY_X_MAX);
+    const __m256 zMax = _mm256_set1_ps(RAY_Z_MAX), zMin = _mm256_set1_ps(-RAY_Z_MAX);
+    const __m256 maxDist = _mm256_set1_ps(maxDistance);
+    const __m256 maxB = _mm256_set1_ps((float)maxBounces);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 px = _mm256_set1_ps(w.ball[shooter].x);
+        __m256 pz = _mm256_set1_ps(w.ball[shooter].z);
+        __m256 dx = _mm256_loadu_ps(dirX + i);
+        __m256 dz = _mm256_loadu_ps(dirZ + i);
+        __m256 dist = zero, bounces = zero;
+        __m256 active = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        __m256 resBall = _mm256_set1_ps(-1.0f), resBounces = zero, resDist = maxDist;
+
+        for (int it = 0; it <= maxBounces && _mm256_movemask_ps(active); it++) {
+            __m256 remaining = _mm256_sub_ps(maxDist, dist);
+
+            __m256 bestT = remaining;
+            __m256 best = _mm256_set1_ps(-1.0f);
+            for (int j = 0; j < m; j++) {
+                __m256 mx = _mm256_sub_ps(px, _mm256_set1_ps(cx[j]));
+                __m256 mz = _mm256_sub_ps(pz, _mm256_set1_ps(cz[j]));
+                __m256 b = _mm256_add_ps(_mm256_mul_ps(mx, dx), _mm256_mul_ps(mz, dz));
+                __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(mx, mx), _mm256_mul_ps(mz, mz)), touch);
+                __m256 disc = _mm256_sub_ps(_mm256_mul_ps(b, b), c);
+                __m256 ahead = _mm256_and_ps(_mm256_cmp_ps(b, zero, _CMP_LT_OQ),
+                                             _mm256_cmp_ps(disc, zero, _CMP_GE_OQ));
+                __m256 t = _mm256_sub_ps(_mm256_xor_ps(b, sign), _mm256_sqrt_ps(_mm256_max_ps(disc, zero)));
+                t = _mm256_max_ps(t, zero);
+                t = _mm256_blendv_ps(inf, t, ahead);
+                t = _mm256_blendv_ps(t, zero, _mm256_cmp_ps(c, zero, _CMP_LE_OQ));
+                __m256 closer = _mm256_cmp_ps(t, bestT, _CMP_LT_OQ);
+                bestT = _mm256_blendv_ps(bestT, t, closer);
+                best = _mm256_blendv_ps(best, _mm256_set1_ps((float)j), closer);
+            }
+
+            __m256 dxPos = _mm256_cmp_ps(dx, zero, _CMP_GT_OQ), dxNeg = _mm256_cmp_ps(dx, zero, _CMP_LT_OQ);
+            __m256 dzPos = _mm256_cmp_ps(dz, zero, _CMP_GT_OQ), dzNeg = _mm256_cmp_ps(dz, zero, _CMP_LT_OQ);
+            __m256 tx = _mm256_div_ps(_mm256_sub_ps(_mm256_blendv_ps(xMin, xMax, dxPos), px), dx);
+            __m256 tz = _mm256_div_ps(_mm256_sub_ps(_mm256_blendv_ps(zMin, zMax, dzPos), pz), dz);
+            tx = _mm256_blendv_ps(inf, tx, _mm256_or_ps(dxPos, dxNeg));
+            tz = _mm256_blendv_ps(inf, tz, _mm256_or_ps(dzPos, dzNeg));
+            __m256 tw = _mm256_blendv_ps(tz, tx, _mm256_cmp_ps(tx, tz, _CMP_LT_OQ));
+
+            // 공에 먼저 닿음
+            __m256 hitBall = _mm256_and_ps(active, _mm256_and_ps(
+                _mm256_cmp_ps(best, zero, _CMP_GE_OQ), _mm256_cmp_ps(bestT, tw, _CMP_LE_OQ)));
+            resBall = _mm256_blendv_ps(resBall, best, hitBall);
+            resBounces = _mm256_blendv_ps(resBounces, bounces, hitBall);
+            resDist = _mm256_blendv_ps(resDist, _mm256_add_ps(dist, bestT), hitBall);
+            active = _mm256_andnot_ps(hitBall, active);
+
+            // 쿠션까지 가기 전에 다 감
+            __m256 spent = _mm256_and_ps(active, _mm256_cmp_ps(tw, remaining, _CMP_GE_OQ));
+            resBounces = _mm256_blendv_ps(resBounces, bounces, spent);
+            active = _mm256_andnot_ps(spent, active);
+
+            // 쿠션에서 반사
+            px = _mm256_blendv_ps(px, _mm256_add_ps(px, _mm256_mul_ps(dx, tw)), active);
+            pz = _mm256_blendv_ps(pz, _mm256_add_ps(pz, _mm256_mul_ps(dz, tw)), active);
+            dist = _mm256_blendv_ps(dist, _mm256_add_ps(dist, tw), active);
+            __m256 flipX = _mm256_and_ps(active, _mm256_cmp_ps(tx, tw, _CMP_LE_OQ));
+            __m256 flipZ = _mm256_and_ps(active, _mm256_cmp_ps(tz, tw, _CMP_LE_OQ));
+            dx = _mm256_xor_ps(dx, _mm256_and_ps(flipX, sign));
+            dz = _mm256_xor_ps(dz, _mm256_and_ps(flipZ, sign));
+            bounces = _mm256_add_ps(bounces, _mm256_and_ps(active, one));
+
+            __m256 tooMany = _mm256_and_ps(active, _mm256_cmp_ps(bounces, maxB, _CMP_GT_OQ));
+            resBounces = _mm256_blendv_ps(resBounces, bounces, tooMany);
+            resDist = _mm256_blendv_ps(resDist, dist, tooMany);
+            active = _mm256_andnot_ps(tooMany, active);
+        }
+
+        float ball[8], nb[8], d[8];
+        _mm256_storeu_ps(ball, resBall);
+        _mm256_storeu_ps(nb, resBounces);
+        _mm256_storeu_ps(d, resDist);
+        for (int k = 0; k < 8; k++) {
+            out[i + k].ball = ball[k] < 0 ? -1 : id[(int)ball[k]];
+            out[i + k].bounces = (int)nb[k];
+            out[i + k].distance = d[k];
+        }
+    }
+    return i;
+}
+
+static bool detectAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;   // OS 가 ymm 레지스터를 저장하는지
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool rayCasterUsesAVX2()
+{
+    static const bool avx2 = detectAVX2();
+    return avx2;
+}
+
+#else
+
+bool rayCasterUsesAVX2()
+{
+    return false;
+}
+
+#endif // RAY_X86
+
+void castRays(const SimWorld& w, int shooter, const float* dirX, const float* dirZ, int n,
+              float maxDistance, int maxBounces, RayHit* out)
+{
+    int done = 0;
+#ifdef RAY_X86
+    if (rayCasterUsesAVX2())
+        done = castRaysAVX2(w, shooter, dirX, dirZ, n, maxDistance, maxBounces, out);
+#endif
+    // 8 개로 안 나눠지는 나머지
+    castRaysScalar(w, shooter, dirX + done, dirZ + done, n - done, maxDistance, maxBounces, out + done);
+}
+
+float shotTravelBound(float power, float dt)
+{
+    const float TIME_SCALE = 3.3f;
+    double rate = 1 - (1 - SIM_DECREASE_RATE) * dt * 400;
+    if (rate < 0)
+        rate = 0;
+    return (float)(TIME_SCALE * dt * power / (1 - rate));
+}
@@ -0,0 +1,38 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: rayCaster.h
+//
+// Desc: 조준 후보를 시뮬레이션하기 전에 기하로만 거르는 batch 광선 검사.
+//       친 공 (반지름 R 원) 이 직선으로 가다가 쿠션에서 반사되는 경로 (조준선 그리기와 같은 방식)
+//       를 따라, 처음 닿는 공과 거기까지의 거리를 구함. 다른 공은 멈춰 있다고 봄.
+//       쿠션은 billiardSim 의 벽 판정과 같은 공 중심 범위 (|x| <= 4.5 - R, |z| <= 3 - R).
+//       AVX2 를 쓸 수 있는 CPU 면 광선 8 개씩, 아니면 하나씩 (결과는 같음).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __rayCasterH__
+#define __rayCasterH__
+
+#include "billiardSim.h"
+
+struct RayHit {
+    int   ball;       // 처음 닿는 공 번호, 없으면 -1
+    int   bounces;    // 닿기 전까지 쿠션 반사 횟수
+    float distance;   // 닿을 때까지 중심이 움직인 거리 (없으면 maxDistance)
+};
+
+// shooter 에서 (dirX[i], dirZ[i]) (단위 벡터) 방향으로 n 개. maxDistance 를 가거나
+// 쿠션에 maxBounces 번 넘게 반사되면 끝.
+void castRays(const SimWorld& w, int shooter, const float* dirX, const float* dirZ, int n,
+              float maxDistance, int maxBounces, RayHit* out);
+
+// 같은 계산을 한 광선씩 (AVX2 경로 확인용)
+void castRaysScalar(const SimWorld& w, int shooter, const float* dirX, const float* dirZ, int n,
+                    float maxDistance, int maxBounces, RayHit* out);
+
+bool rayCasterUsesAVX2();
+
+// simFire 로 세기 power 로 쳤을 때 중심이 갈 수 있는 거리의 상한 (마찰만 있을 때)
+float shotTravelBound(float power, float dt = SIM_TIME_STEP);
+
+#endif // __rayCasterH__
@@ -0,0 +1,325 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: shotPlanner.cpp
+//
+// Desc: 여러 턴을 내다보는 샷 탐색
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shotPlanner.h"
+#include "arena.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+
+typedef std::chrono::steady_clock PlannerClock;
+
+// 캐시에서 key 자리부터 이만큼 이어서 찾음. 다 차 있으면 그중 가장 덜 아까운 것을 바꿈.
+const int CACHE_PROBE = 8;
+// 이만큼의 결정 동안 쓰이지 않은 엔트리는 깊이와 상관없이 먼저 바꿈
+const unsigned CACHE_KEEP_TURNS = 8;
+
+struct CShotPlanner::Search {
+    PlannerClock::time_point deadline;
+    unsigned               generation;
+    std::atomic<bool>      timedOut;
+    std::atomic<long long> simulations;
+    std::atomic<int>       cacheHits;
+
+    bool expired(void)
+    {
+        if (timedOut.load(std::memory_order_relaxed)) return true;
+        if (PlannerClock::now() < deadline) return false;
+        timedOut = true;
+        return true;
+    }
+};
+
+PlannerConfig DefaultPlannerConfig()
+{
+    PlannerConfig cfg;
+    cfg.maxDepth = 3;
+    cfg.timeBudgetMs = 200;
+    cfg.angles = 32;
+    cfg.noiseSamples = 3;
+    cfg.aimNoise = 0.02f;
+    cfg.discount = 0.9f;
+    cfg.cacheLimit = 200000;
+    return cfg;
+}
+
+CShotPlanner::CShotPlanner(CThreadPool& pool, const PlannerConfig& cfg)
+    : m_pool(pool), m_cfg(cfg), m_generation(0)
+{
+    if (m_cfg.angles < 1) m_cfg.angles = 1;
+    if (m_cfg.noiseSamples < 1) m_cfg.noiseSamples = 1;
+    if (m_cfg.maxDepth < 1) m_cfg.maxDepth = 1;
+
+    size_t size = CACHE_PROBE;
+    while (size < (size_t)m_cfg.cacheLimit) size <<= 1;
+    m_cache.assign(size, CacheEntry());
+    m_cacheMask = size - 1;
+    clearCache();
+}
+
+void CShotPlanner::clearCache()
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    for (size_t i = 0; i < m_cache.size(); i++) m_cache[i].key = 0;
+}
+
+void CShotPlanner::candidateTarget(const SimWorld& w, int shooter, int c, float angleOffset,
+                                   float powerScale, float& tx, float& tz) const
+{
+    const double PI = 3.14159265358979;
+    int a = c / PLANNER_POWER_COUNT;
+    int p = c % PLANNER_POWER_COUNT;
+    double theta = 2 * PI * a / m_cfg.angles + angleOffset;
+    float power = PLANNER_POWERS[p] * powerScale;
+    tx = w.ball[shooter].x + (float)(power * cos(theta));
+    tz = w.ball[shooter].z + (float)(power * sin(theta));
+}
+
+float CShotPlanner::shotValue(const SimGame& g, int c, int depth, Search& s)
+{
+    int shooter = g.isWhiteTurn == 1 ? BALL_WHITE : BALL_YELLOW;
+    float sum = 0;
+
+    // 오차 샘플: 0, +σ, -σ, +2σ, -2σ ... (세기는 방향 오차 쪽으로 ±5% 씩)
+    for (int k = 0; k < m_cfg.noiseSamples; k++) {
+        if (s.expired()) return 0;
+
+        int step = (k + 1) / 2;
+        float sign = (k % 2) ? 1.0f : -1.0f;
+        float angleOffset = sign * step * m_cfg.aimNoise;
+        float powerScale = 1.0f + sign * step * 0.05f;
+
+        SimGame next = g;
+        float tx, tz;
+        candidateTarget(next.world, shooter, c, angleOffset, powerScale, tx, tz);
+        int score = simGameShot(next, tx, tz);
+        s.simulations++;
+
+        float q = (float)score;
+        if (score == 1 && depth > 1) {
+            // 득점하면 턴 유지: 남은 배치에서 같은 쪽이 다시 침 (멈출 때까지 이어서 진행)
+            simSettle(next.world);
+            simClearHits(next.world);
+            q += m_cfg.discount * layoutValue(next, depth - 1, s);
+        }
+        sum += q;
+    }
+    return sum / m_cfg.noiseSamples;
+}
+
+float CShotPlanner::layoutValue(const SimGame& g, int depth, Search& s)
+{
+    unsigned long long key = layoutKey(g.world, g.isWhiteTurn);
+    CacheEntry cached;
+    if (cacheLookup(key, depth, s.generation, cached)) {
+        s.cacheHits++;
+        return cached.value;
+    }
+
+    // 얕게 본 적이 있으면 그때의 best 부터 (시간이 끊겨도 좋은 후보는 본 셈)
+    int hint = cached.key ? cached.best : -1;
+    float best = -1;
+    int bestC = -1;
+    unsigned long long scoring[2] = { 0, 0 };
+    for (int i = hint >= 0 ? -1 : 0; i < candidateCount(); i++) {
+        int c = i < 0 ? hint : i;
+        if (i >= 0 && c == hint) continue;
+        float q = shotValue(g, c, depth, s);
+        if (s.expired()) return best;
+        if (q > 0 && c < 128) scoring[c / 64] |= 1ULL << (c % 64);
+        if (q > best) {
+            best = q;
+            bestC = c;
+        }
+    }
+    cacheStore(key, depth, best, bestC, scoring, s.generation);
+    return best;
+}
+
+unsigned long long CShotPlanner::layoutKey(const SimWorld& w, int isWhiteTurn) const
+{
+    // FNV-1a, 좌표는 1e-3 단위로 양자화
+    unsigned long long h = 1469598103934665603ULL;
+    for (int i = 0; i < SIM_BALLS; i++) {
+        long long q[2] = { llround(w.ball[i].x * 1000.0), llround(w.ball[i].z * 1000.0) };
+        for (int k = 0; k < 2; k++) {
+            h ^= (unsigned long long)q[k];
+            h *= 1099511628211ULL;
+        }
+    }
+    h ^= (unsigned long long)(isWhiteTurn + 2);
+    h *= 1099511628211ULL;
+    return h ? h : 1;   // 0 은 빈 칸 표시
+}
+
+bool CShotPlanner::cacheLookup(unsigned long long key, int depth, unsigned generation, CacheEntry& entry)
+{
+    entry.key = 0;
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    for (int k = 0; k < CACHE_PROBE; k++) {
+        CacheEntry& e = m_cache[(key + k) & m_cacheMask];
+        if (e.key != key) continue;
+        e.used = generation;
+        entry = e;
+        return e.depth >= depth;
+    }
+    return false;
+}
+
+// 바꿀 자리 우선순위: 빈 칸, 오래 안 쓴 것, 얕은 것 (작을수록 먼저 바꿈)
+static int victimRank(bool filled, unsigned used, int depth, unsigned generation)
+{
+    if (!filled) return -1;
+    if (generation - used > CACHE_KEEP_TURNS) return 0;
+    return 1 + depth;
+}
+
+void CShotPlanner::cacheStore(unsigned long long key, int depth, float value, int best,
+                              const unsigned long long* scoring, unsigned generation)
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    CacheEntry* slot = NULL;
+    int slotRank = 0;
+    for (int k = 0; k < CACHE_PROBE; k++) {
+        CacheEntry& e = m_cache[(key + k) & m_cacheMask];
+        if (e.key == key) {
+            e.used = generation;
+            if (e.depth > depth) return;   // 더 깊이 본 값이 있음
+            slot = &e;
+            break;
+        }
+        int rank = victimRank(e.key != 0, e.used, e.depth, generation);
+        if (!slot || rank < slotRank) {
+            slot = &e;
+            slotRank = rank;
+        }
+    }
+    slot->key = key;
+    slot->value = value;
+    slot->depth = (short)depth;
+    slot->best = (short)best;
+    slot->scoring[0] = scoring[0];
+    slot->scoring[1] = scoring[1];
+    slot->used = generation;
+}
+
+PlannedShot CShotPlanner::plan(const SimWorld& world, int isWhiteTurn, double budgetMs)
+{
+    PlannedShot result;
+    result.value = -1;
+    result.depth = 0;
+    result.simulations = 0;
+    result.cacheHits = 0;
+    result.reusedDepth = 0;
+    int shooter = isWhiteTurn == 1 ? BALL_WHITE : BALL_YELLOW;
+    candidateTarget(world, shooter, 0, 0, 1.0f, result.targetX, result.targetZ);
+
+    Search s;
+    s.generation = ++m_generation;
+
+    // 이전 턴 탐색에서 이 배치 (득점 후 이어 칠 배치) 를 이미 봤으면 그 답에서 시작
+    int n = candidateCount();
+    unsigned long long rootKey = layoutKey(world, isWhiteTurn);
+    CacheEntry seed;
+    bool deepEnough = cacheLookup(rootKey, m_cfg.maxDepth, s.generation, seed);
+    bool seeded = seed.key != 0 && seed.best >= 0 && seed.best < n;
+    if (deepEnough && seeded) {
+        candidateTarget(world, shooter, seed.best, 0, 1.0f, result.targetX, result.targetZ);
+        result.value = seed.value;
+        result.depth = seed.depth;
+        result.cacheHits = 1;
+        result.reusedDepth = seed.depth;
+        return result;
+    }
+
+    if (budgetMs <= 0) budgetMs = m_cfg.timeBudgetMs;
+    s.deadline = PlannerClock::now() +
+        std::chrono::microseconds((long long)(budgetMs * 1000));
+    s.timedOut = false;
+    s.simulations = 0;
+    s.cacheHits = 0;
+
+    // 결정 한 번 동안의 후보 배열은 스레드마다 둔 arena 에서 (매 결정 reset, 힙 할당 없음)
+    static thread_local CArena arena;
+    arena.reset();
+
+    SimGame root;
+    simGameReset(root, SHRT_MAX);   // 탐색에서는 승자를 따지지 않음
+    root.world = world;
+    root.isWhiteTurn = (signed char)isWhiteTurn;
+
+    float* values = arena.alloc<float>(n);
+    int* active = arena.alloc<int>(n);
+    int activeCount = 0;
+    int firstDepth = 1;
+    for (int c = 0; c < n; c++) values[c] = -1.0f;
+    if (seeded && scoringKnown()) {
+        // seed.depth 까지는 이전 턴이 본 것: 그 깊이의 득점 후보만 들고 다음 깊이부터 이어서 봄.
+        // 나머지 후보의 값은 모르므로 -1 (득점 못 한 후보라 0 이하였음)
+        for (int c = 0; c < n; c++) {
+            if (seed.scoring[c / 64] & (1ULL << (c % 64))) active[activeCount++] = c;
+        }
+        values[seed.best] = seed.value;
+        result.depth = seed.depth;
+        result.reusedDepth = seed.depth;
+        firstDepth = seed.depth + 1;
+    }
+    else {
+        for (int c = 0; c < n; c++) active[activeCount++] = c;
+    }
+    if (seeded) {
+        // 캐시의 best 를 먼저 (시간이 끊기기 전에 보도록)
+        for (int i = 0; i < activeCount; i++) {
+            if (active[i] == seed.best) std::swap(active[0], active[i]);
+        }
+    }
+
+    // 반복 심화: 깊이 1 에서 모든 후보, 그 다음부터는 한 번이라도 득점한 후보만 더 깊이 봄
+    for (int depth = firstDepth; depth <= m_cfg.maxDepth && activeCount > 0; depth++) {
+        TRACE_SCOPE("plan depth");
+        float* next = arena.alloc<float>(n);
+        std::copy(values, values + n, next);
+        m_pool.parallelFor(activeCount, [&](int i) {
+            int c = active[i];
+            next[c] = shotValue(root, c, depth, s);
+        });
+        if (s.timedOut) break;   // 끝까지 못 본 깊이는 버림
+
+        values = next;
+        result.depth = depth;
+
+        int scoring = 0;
+        for (int i = 0; i < activeCount; i++) {
+            if (values[active[i]] > 0) active[scoring++] = active[i];
+        }
+        activeCount = scoring;
+    }
+
+    int bestC = seeded ? seed.best : 0;
+    for (int c = 0; c < n; c++) {
+        if (values[c] > values[bestC]) bestC = c;
+    }
+    if (result.depth > 0) {
+        candidateTarget(world, shooter, bestC, 0, 1.0f, result.targetX, result.targetZ);
+        result.value = values[bestC];
+
+        // 남은 active 가 마지막으로 끝까지 본 깊이의 득점 후보
+        unsigned long long scoring[2] = { 0, 0 };
+        for (int i = 0; i < activeCount; i++) {
+            int c = active[i];
+            if (c < 128) scoring[c / 64] |= 1ULL << (c % 64);
+        }
+        cacheStore(rootKey, result.depth, result.value, bestC, scoring, s.generation);
+    }
+    result.simulations = s.simulations;
+    result.cacheHits = s.cacheHits;
+    return result;
+}
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: shotPlanner.h
+//
+// Desc: 여러 턴을 내다보는 샷 탐색 (expectimax).
+//       updateScore 는 getScore 가 +1 이면 턴을 유지하므로,
+//       득점하면서 다음 샷도 치기 좋은 배치를 남기는 샷의 가치를 더 높게 봄.
+//         Q(샷) = E_오차[ 점수 + (점수 == +1 ? discount * V(남은 배치, depth-1) : 0) ]
+//         V(배치) = max_샷 Q(샷)
+//       루트 후보는 스레드 풀에서 나눠서 평가하고, 시간 예산 안에서 깊이를 하나씩 늘림.
+//       평가한 배치는 값, 본 깊이, 가장 좋은 후보, 그 깊이에서 득점한 후보 집합을 캐시에 남김.
+//       득점 뒤 이어 칠 배치는 이전 턴의 탐색에서 이미 평가되었으므로, 다음 턴 루트가 캐시에 있으면
+//       maxDepth 까지 본 것은 탐색 없이 그대로 쓰고, 얕으면 캐시의 득점 후보만 들고 그 다음 깊이부터
+//       이어서 봄 (시간이 모자라면 캐시의 답).
+//       캐시는 생성자에서 한 번 잡는 고정 크기 표라 탐색 중에는 힙을 쓰지 않음
+//       (가지는 SimGame 을 스택에 복사, 후보 배열은 결정마다 reset 하는 arena).
+//       자리가 모자라면 오래 안 쓴 (CACHE_KEEP_TURNS 결정 전) 것, 그다음 얕은 것부터 바꿈.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __shotPlannerH__
+#define __shotPlannerH__
+
+#include "billiardSim.h"
+#include "threadPool.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+struct PlannerConfig {
+    int    maxDepth;       // 연속 샷 몇 개까지 볼지
+    double timeBudgetMs;   // 결정 한 번에 쓸 시간
+    int    angles;         // 방향 후보 수 (x 세기 후보 PLANNER_POWER_COUNT 개)
+    int    noiseSamples;   // 샷 오차 샘플 수 (1 이면 오차 없음)
+    float  aimNoise;       // 방향 오차 (rad)
+    float  discount;       // 다음 샷 가치 할인
+    int    cacheLimit;     // 캐시 엔트리 수 (2 의 거듭제곱으로 올림, 생성자에서 한 번 잡음)
+};
+
+const int   PLANNER_POWER_COUNT = 4;
+const float PLANNER_POWERS[PLANNER_POWER_COUNT] = { 1.5f, 3.0f, 5.0f, 8.0f };
+
+PlannerConfig DefaultPlannerConfig();
+
+struct PlannedShot {
+    float     targetX, targetZ;   // 파란공 조준점
+    float     value;              // 기대 가치
+    int       depth;              // 끝까지 본 깊이
+    long long simulations;
+    int       cacheHits;
+    int       reusedDepth;        // 이전 결정의 캐시에서 이어받은 깊이 (0: 처음부터 탐색)
+};
+
+class CShotPlanner {
+public:
+    CShotPlanner(CThreadPool& pool, const PlannerConfig& cfg = DefaultPlannerConfig());
+
+    // 모든 공이 멈춘 배치에서 isWhiteTurn 쪽 공의 가장 좋은 샷. budgetMs <= 0 이면 설정값.
+    PlannedShot plan(const SimWorld& world, int isWhiteTurn, double budgetMs = 0);
+    void clearCache();
+
+private:
+    struct Search;   // 결정 한 번 동안의 시간 제한/통계
+
+    // open addressing 표의 한 칸. key 0 은 빈 칸.
+    struct CacheEntry {
+        unsigned long long key;
+        unsigned long long scoring[2];   // depth 에서 값이 0 보다 큰 후보 (후보 128 개 이하일 때만)
+        float              value;
+        short              depth;
+        short              best;         // 가장 좋은 후보 번호
+        unsigned           used;         // 마지막으로 쓴 결정 번호 (m_generation)
+    };
+
+    int   candidateCount() const { return m_cfg.angles * PLANNER_POWER_COUNT; }
+    void  candidateTarget(const SimWorld& w, int shooter, int c, float angleOffset,
+                          float powerScale, float& tx, float& tz) const;
+    // 가지마다 SimGame 을 복사해서 진행 (힙 할당 없음)
+    float shotValue(const SimGame& g, int c, int depth, Search& s);
+    float layoutValue(const SimGame& g, int depth, Search& s);
+
+    unsigned long long layoutKey(const SimWorld& w, int isWhiteTurn) const;
+    // depth 이상으로 본 값이 있으면 true. 얕은 것만 있어도 entry 에 복사해 줌 (없으면 entry.key == 0).
+    bool  cacheLookup(unsigned long long key, int depth, unsigned generation, CacheEntry& entry);
+    void  cacheStore(unsigned long long key, int depth, float value, int best,
+                     const unsigned long long* scoring, unsigned generation);
+    bool  scoringKnown() const { return candidateCount() <= 128; }
+
+    CThreadPool&  m_pool;
+    PlannerConfig m_cfg;
+    std::mutex    m_cacheMutex;
+    std::vector<CacheEntry> m_cache;   // 크기는 생성자에서 정하고 바꾸지 않음
+    size_t        m_cacheMask;
+    std::atomic<unsigned> m_generation;   // plan() 할 때마다 1 씩
+};
+
+#endif // __shotPlannerH__
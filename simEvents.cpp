@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: simEvents.cpp
+//
+// Desc: 이벤트 버스 dispatch 와 3 쿠션 판정
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "simEvents.h"
+
+int CEventBus::dispatch()
+{
+    int count = 0;
+    SimEvent e;
+    while (m_ring.pop(e)) {
+        for (size_t i = 0; i < m_handlers.size(); i++) m_handlers[i](e);
+        count++;
+    }
+    return count;
+}
+
+CThreeCushionJudge::CThreeCushionJudge(int source)
+    : m_source(source), m_ball(-1), m_cushions(0), m_reds(0), m_made(false), m_foul(false), m_lastMade(false)
+{
+    m_points[0] = m_points[1] = 0;
+}
+
+void CThreeCushionJudge::attach(CEventBus& bus)
+{
+    bus.subscribe([this](const SimEvent& e) { onEvent(e); });
+}
+
+void CThreeCushionJudge::onEvent(const SimEvent& e)
+{
+    if (e.source != m_source) return;
+
+    switch (e.type) {
+    case EVENT_SHOT_FIRED:
+        m_ball = e.ball;
+        m_cushions = m_reds = 0;
+        m_made = m_foul = false;
+        break;
+    case EVENT_CUSHION:
+        if (e.ball == m_ball) m_cushions++;
+        break;
+    case EVENT_BALL_CONTACT: {
+        if (m_ball < 0 || (e.ball != m_ball && e.other != m_ball)) break;
+        int target = e.ball == m_ball ? e.other : e.ball;
+        if (target != BALL_RED1 && target != BALL_RED2) {
+            m_foul = true;
+            break;
+        }
+        // 접촉은 쌍마다 한 번씩 시작되므로 (떨어졌다 다시 닿으면 또) 처음 닿은 빨간 공만 셈
+        if (m_reds == 0) m_reds = 1 << target;
+        else if (!(m_reds & (1 << target))) {
+            m_reds |= 1 << target;
+            m_made = m_cushions >= 3;
+        }
+        break;
+    }
+    case EVENT_TURN_END:
+        if (m_ball < 0) break;
+        m_lastMade = m_made && !m_foul;
+        if (m_lastMade) m_points[e.player == 1 ? 0 : 1]++;
+        m_ball = -1;
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: simEvents.h
+//
+// Desc: 게임 이벤트 (공끼리 접촉, 쿠션, 공 멈춤, 발사, 턴 끝, 점수 변화) 와 이벤트 버스.
+//       세션 (시뮬레이션 스레드, match server 의 shard 들) 이 publish 로 MPSC ring 에 넣고,
+//       한 소비자 스레드 (화면 등) 가 dispatch 로 꺼내 구독자들에게 차례로 넘김.
+//       구독자가 몇이든 시뮬레이션 쪽 일은 이벤트당 push 한 번.
+//       hit / 점수를 턴이 끝난 뒤 들여다보는 대신, 턴 안에서 일어난 순서를 그대로 볼 수 있음
+//       (3 쿠션 판정이 그 예).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __simEventsH__
+#define __simEventsH__
+
+#include "billiardSim.h"
+#include "eventRing.h"
+#include <atomic>
+#include <functional>
+#include <vector>
+
+enum SimEventType {
+    EVENT_BALL_CONTACT,   // ball 과 other 의 접촉 시작. value: 부딪힌 상대 속력
+    EVENT_CUSHION,        // ball 이 쿠션에 부딪힘. value: 튕긴 뒤 속력
+    EVENT_BALL_STOPPED,   // ball 의 속도가 0 이 됨
+    EVENT_SHOT_FIRED,     // player 가 ball 을 침. value: 세기 (조준점까지 거리)
+    EVENT_TURN_END,       // player 의 턴이 끝남. value: getScore (-1, 0, 1)
+    EVENT_SCORE_CHANGE,   // player 의 점수가 바뀜. value: 새 점수
+};
+
+struct SimEvent {
+    unsigned char  type;      // SimEventType
+    signed char    ball;
+    signed char    other;     // EVENT_BALL_CONTACT 만
+    signed char    player;    // 1: 흰 공, -1: 노란 공 (그 턴의 isWhiteTurn)
+    unsigned short step;      // 샷 안의 step (SimWorld::step)
+    unsigned short source;    // 발행한 세션 번호 (setEventBus)
+    int            turn;      // 이 이벤트가 속한 턴 (turnCount, 0 부터)
+    float          value;
+};
+
+class CEventBus {
+public:
+    typedef std::function<void(const SimEvent&)> Handler;
+
+    CEventBus() : m_dropped(0) {}
+
+    // 아무 스레드에서나. ring 이 차 있으면 버리고 dropped() 를 늘림.
+    void publish(const SimEvent& e)
+    {
+        if (!m_ring.push(e)) m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 아래는 소비자 스레드에서만
+    void subscribe(const Handler& handler) { m_handlers.push_back(handler); }
+    // 쌓인 이벤트를 모두 구독자에게 (넣은 순서대로). 넘긴 이벤트 수 반환.
+    int dispatch();
+    unsigned dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    CMpscRing<SimEvent, 4096> m_ring;
+    std::vector<Handler>      m_handlers;
+    std::atomic<unsigned>     m_dropped;
+};
+
+// 3 쿠션 판정 (4 구 배치, 빨간 공 둘이 목적구). 친 공이 상대 공에 닿지 않고 두 빨간 공에 모두
+// 닿으면서, 두 번째 빨간 공에 닿기 전에 쿠션을 3 번 이상 맞혔으면 득점.
+// 한 세션 (source) 의 이벤트만 봄.
+class CThreeCushionJudge {
+public:
+    explicit CThreeCushionJudge(int source = 0);
+
+    void onEvent(const SimEvent& e);
+    void attach(CEventBus& bus);   // bus 의 구독자로 등록
+
+    int points(int player) const { return player == 1 ? m_points[0] : m_points[1]; }
+    bool lastMade() const { return m_lastMade; }   // 마지막으로 끝난 턴의 득점 여부
+
+private:
+    int  m_source;
+    int  m_ball;            // 이번 샷에서 친 공 (-1: 샷 전)
+    int  m_cushions;        // 친 공의 쿠션 수
+    int  m_reds;            // 친 공이 닿은 빨간 공 수
+    bool m_made, m_foul;
+    bool m_lastMade;
+    int  m_points[2];       // 흰 공, 노란 공
+};
+
+#endif // __simEventsH__
@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: simReference.cpp
+//
+// Desc: 기준 물리 (고정본, 고치지 말 것)
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "simReference.h"
+#include <cmath>
+#include <cstring>
+
+namespace simref {
+
+void reset(World& w) {
+    for (int i = 0; i < BALLS; i++) {
+        w.ball[i].x = START_POS[i][0];
+        w.ball[i].z = START_POS[i][1];
+        w.ball[i].vx = w.ball[i].vz = 0;
+    }
+    clearHits(w);
+}
+
+void clearHits(World& w) {
+    memset(w.hit, 0, sizeof(w.hit));
+}
+
+// CSphere::ballUpdate
+static void ballUpdate(Ball& b, float timeDiff) {
+    const float TIME_SCALE = 3.3f;
+    double vx = fabs((double)b.vx);
+    double vz = fabs((double)b.vz);
+
+    if (vx > 0.01 || vz > 0.01) {
+        float tX = b.x + TIME_SCALE * timeDiff * b.vx;
+        float tZ = b.z + TIME_SCALE * timeDiff * b.vz;
+
+        // 벽 쪽 위치 보정 (원래 코드처럼 한 번에 한 축만)
+        if (tX >= (4.5 - RADIUS))
+            tX = (float)(4.5 - RADIUS);
+        else if (tX <= (-4.5 + RADIUS))
+            tX = (float)(-4.5 + RADIUS);
+        else if (tZ <= (-3 + RADIUS))
+            tZ = (float)(-3 + RADIUS);
+        else if (tZ >= (3 - RADIUS))
+            tZ = (float)(3 - RADIUS);
+
+        b.x = tX;
+        b.z = tZ;
+    }
+    else {
+        b.vx = b.vz = 0;
+    }
+    double rate = 1 - (1 - DECREASE_RATE) * timeDiff * 400;
+    if (rate < 0)
+        rate = 0;
+    b.vx = (float)(b.vx * rate);
+    b.vz = (float)(b.vz * rate);
+}
+
+// CWall::hitBy. wall 0: 위 (z = 3.06), 1: 아래, 2: 오른쪽 (x = 4.56), 3: 왼쪽. 두께 0.12
+static void wallHitBy(int wall, Ball& b) {
+    const float r = (float)RADIUS;
+    const float half = 0.12f / 2;
+    switch (wall) {
+    case 0: if (b.z + r >= 3.06f - half) b.vz = -b.vz; break;
+    case 1: if (b.z - r <= -3.06f + half) b.vz = -b.vz; break;
+    case 2: if (b.x + r >= 4.56f - half) b.vx = -b.vx; break;
+    case 3: if (b.x - r <= -4.56f + half) b.vx = -b.vx; break;
+    }
+}
+
+// CSphere::hitBy (this = i, ball = j)
+static void ballHitBy(World& w, int i, int j) {
+    Ball& a = w.ball[i];
+    Ball& b = w.ball[j];
+    const float radiusSum = (float)RADIUS + (float)RADIUS;
+
+    float dx = a.x - b.x;
+    float dz = a.z - b.z;
+    float distance = sqrtf(dx * dx + dz * dz);
+    if (distance > radiusSum) return;
+
+    // hasIntersected: 서로의 hit 갱신
+    w.hit[j] |= (unsigned char)(1 << i);
+    w.hit[i] |= (unsigned char)(1 << j);
+
+    float nx = 0, nz = 0;
+    if (distance > 0) {
+        nx = dx / distance;
+        nz = dz / distance;
+    }
+
+    // 두 공이 서로 멀어지는 중이면 무시
+    if ((a.vx - b.vx) * nx + (a.vz - b.vz) * nz > 0)
+        return;
+
+    // 질량이 같은 완전탄성 충돌: 법선 성분 교환
+    float v1n = a.vx * nx + a.vz * nz;
+    float v2n = b.vx * nx + b.vz * nz;
+    float p = v1n - v2n;
+    a.vx -= nx * p;
+    a.vz -= nz * p;
+    b.vx += nx * p;
+    b.vz += nz * p;
+
+    // 살짝 겹쳐진 공 위치 보정
+    float overlap = (radiusSum - distance) * 0.5f;
+    if (overlap > 0) {
+        a.x += nx * overlap;
+        a.z += nz * overlap;
+        b.x -= nx * overlap;
+        b.z -= nz * overlap;
+    }
+}
+
+void step(World& w, float dt) {
+    // Display() 와 같은 순서: 공 i 이동 후 벽 i 와 모든 공 검사
+    for (int i = 0; i < BALLS; i++) {
+        ballUpdate(w.ball[i], dt);
+        for (int j = 0; j < BALLS; j++) wallHitBy(i, w.ball[j]);
+    }
+    for (int i = 0; i < BALLS; i++) {
+        for (int j = i + 1; j < BALLS; j++) ballHitBy(w, i, j);
+    }
+}
+
+bool allStopped(const World& w) {
+    for (int i = 0; i < BALLS; i++) {
+        if (fabs(w.ball[i].vx) > STOP_SPEED || fabs(w.ball[i].vz) > STOP_SPEED)
+            return false;
+    }
+    return true;
+}
+
+int run(World& w, float dt, int maxSteps) {
+    int steps = 0;
+    while (steps < maxSteps && !allStopped(w)) {
+        step(w, dt);
+        steps++;
+    }
+    return steps;
+}
+
+// allStopped 뒤에도 Display() 는 ballUpdate 를 계속 부르므로 남은 느린 움직임이 0 이 될 때까지
+int settle(World& w, float dt, int maxSteps) {
+    int steps = 0;
+    for (; steps < maxSteps; steps++) {
+        bool moving = false;
+        for (int i = 0; i < BALLS; i++)
+            moving = moving || w.ball[i].vx != 0 || w.ball[i].vz != 0;
+        if (!moving) break;
+        step(w, dt);
+    }
+    return steps;
+}
+
+void fire(World& w, int ball, float targetX, float targetZ) {
+    Ball& b = w.ball[ball];
+    double theta = atan2(targetZ - b.z, targetX - b.x);
+    double dist = sqrt(pow(targetX - b.x, 2) + pow(targetZ - b.z, 2));
+    b.vx = (float)(dist * cos(theta));
+    b.vz = (float)(dist * sin(theta));
+}
+
+static bool hit(const World& w, int ball, int other) { return (w.hit[ball] >> other) & 1; }
+
+int turnScore(const World& w, int isWhiteTurn) {
+    int shooter, opponent;
+    if (isWhiteTurn == 1) { shooter = 3; opponent = 2; }
+    else if (isWhiteTurn == -1) { shooter = 2; opponent = 3; }
+    else return 0;
+
+    bool r1 = hit(w, shooter, 0);
+    bool r2 = hit(w, shooter, 1);
+    if (hit(w, shooter, opponent) || (!r1 && !r2)) return -1;
+    if (r1 && r2) return 1;
+    return 0;
+}
+
+int aiPoint(const World& w) {
+    bool h0 = hit(w, 2, 0);
+    bool h1 = hit(w, 2, 1);
+    bool h2 = hit(w, 2, 2);
+    bool h3 = hit(w, 2, 3);
+
+    if (h3) return -1;   // 흰공과 부딪히면 파울
+    if (h0 && h1 && !h2) return +2;
+    if ((h0 ^ h1) && !h2) return +1;
+    if (!h0 && !h1 && !h2) return -1;
+    return 0;
+}
+
+} // namespace simref
@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: simReference.h
+//
+// Desc: 기준 물리 (고정본). 원래 게임의 CSphere::ballUpdate / hitBy, CWall::hitBy, getScore 를
+//       Display() 순서 그대로 옮겨 둔 것으로, 빠른 엔진 (billiardSimCore.h 의 float / double /
+//       Fixed, 이후의 SIMD / 배치 엔진) 이 원래 동작에서 벗어나지 않았는지 비교하는 기준
+//       (simTool golden). 기준이 바뀌면 비교가 의미 없으므로 이 파일과 simReference.cpp 는
+//       고치지 말 것. 그래서 billiardSim.h 의 타입/상수도 쓰지 않고 값을 따로 둠.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __simReferenceH__
+#define __simReferenceH__
+
+namespace simref {
+
+const int    BALLS = 4;                 // 0: r, 1: r, 2: y, 3: w
+const double RADIUS = 0.21;             // M_RADIUS
+const double DECREASE_RATE = 0.9982;    // DECREASE_RATE
+const float  TIME_STEP = 0.007f;        // 10ms 프레임의 timeDelta
+const float  STOP_SPEED = 0.03f;        // allStopped 기준
+const int    MAX_STEPS = 20000;
+
+// spherePos
+const float START_POS[BALLS][2] = { {-2.7f,0} , {+2.4f,0} , {3.3f, 0} , {-2.7f,-0.9f} };
+
+struct Ball {
+    float x, z;
+    float vx, vz;
+};
+
+struct World {
+    Ball          ball[BALLS];
+    unsigned char hit[BALLS];   // CSphere::hit (bit j: 공 j 와 닿음)
+};
+
+void reset(World& w);   // spherePos, 정지, hit 비움
+void clearHits(World& w);
+void step(World& w, float dt);   // 한 프레임: 공마다 ballUpdate 후 벽, 그 다음 모든 공 쌍 hitBy
+bool allStopped(const World& w);
+int  run(World& w, float dt = TIME_STEP, int maxSteps = MAX_STEPS);   // allStopped 까지. step 수 반환.
+int  settle(World& w, float dt = TIME_STEP, int maxSteps = MAX_STEPS);   // 속도가 모두 0 이 될 때까지
+void fire(World& w, int ball, float targetX, float targetZ);          // VK_SPACE
+
+// CSphere::getScore (isWhiteTurn 1: 흰 공, -1: 노란 공) 와 calculateAIPoint
+int turnScore(const World& w, int isWhiteTurn);
+int aiPoint(const World& w);
+
+} // namespace simref
+
+#endif // __simReferenceH__
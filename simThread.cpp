@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: simThread.cpp
+//
+// Desc: 시뮬레이션 스레드
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "simThread.h"
+#include "trace.h"
+#include <chrono>
+
+typedef std::chrono::steady_clock SimClock;
+
+// 화면 쪽이 멈춰 있다 돌아왔을 때 한 번에 따라잡는 최대 tick 수 (그 이상은 버림)
+static const int MAX_CATCH_UP = 25;
+
+static bool sameSnapshot(const GameSnapshot& a, const GameSnapshot& b)
+{
+    for (int i = 0; i < SIM_BALLS; i++) {
+        if (a.ball[i].x != b.ball[i].x || a.ball[i].z != b.ball[i].z ||
+            a.ball[i].vx != b.ball[i].vx || a.ball[i].vz != b.ball[i].vz) return false;
+    }
+    return a.targetX == b.targetX && a.targetZ == b.targetZ && a.isWhiteTurn == b.isWhiteTurn &&
+           a.isTurnStarted == b.isTurnStarted && a.isThinking == b.isThinking &&
+           a.whiteScore == b.whiteScore && a.yellowScore == b.yellowScore &&
+           a.winner == b.winner && a.turnCount == b.turnCount;
+}
+
+CSimThread::CSimThread(CGameSession& session, double tickMs)
+    : m_session(session), m_tickMs(tickMs), m_running(false), m_wake(0), m_wakeContext(0)
+{
+    m_session.snapshot(m_snapshots.back());
+    m_published = m_snapshots.back();
+    m_snapshots.publish();
+}
+
+CSimThread::~CSimThread()
+{
+    stop();
+}
+
+void CSimThread::start()
+{
+    if (m_running) return;
+    m_running = true;
+    m_thread = std::thread([this] { run(); });
+}
+
+void CSimThread::stop()
+{
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool CSimThread::post(const GameInput& input)
+{
+    return m_input.push(input);
+}
+
+const GameSnapshot& CSimThread::latest()
+{
+    m_snapshots.update();
+    return m_snapshots.front();
+}
+
+void CSimThread::apply(const GameInput& input)
+{
+    switch (input.type) {
+    case INPUT_FIRE:
+        m_session.fire();
+        break;
+    case INPUT_AIM:
+        if (m_session.isWhiteTurn() == 1)
+            m_session.setTarget(m_session.getTargetX() + input.dx, m_session.getTargetZ() + input.dz);
+        break;
+    }
+}
+
+void CSimThread::run()
+{
+    const SimClock::duration tick = std::chrono::duration_cast<SimClock::duration>(
+        std::chrono::duration<double, std::milli>(m_tickMs));
+    const float dt = (float)(m_tickMs * 0.0007);   // EnterMsgLoop 과 같은 환산 (10ms -> SIM_TIME_STEP)
+    SimClock::time_point next = SimClock::now();
+    traceThreadName("sim thread");
+
+    while (m_running) {
+        GameInput input;
+        while (m_input.pop(input)) apply(input);
+
+        // 늦어진 만큼 고정 간격으로 따라잡음
+        int steps = 0;
+        SimClock::time_point now = SimClock::now();
+        while (next <= now && steps < MAX_CATCH_UP) {
+            m_session.step(dt);
+            next += tick;
+            steps++;
+        }
+        if (next <= now) next = now + tick;
+
+        // 바뀐 것이 있을 때만 내보내고 화면을 깨움 (턴 끝 뒤 조준점 이동처럼 공이 멈춘 뒤의 변화도)
+        if (steps > 0) {
+            GameSnapshot& back = m_snapshots.back();
+            m_session.snapshot(back);
+            if (!sameSnapshot(back, m_published)) {
+                m_published = back;
+                m_snapshots.publish();
+                if (m_wake) m_wake(m_wakeContext);
+            }
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: simThread.h
+//
+// Desc: 물리/점수/AI 를 화면과 다른 스레드에서 돌리는 시뮬레이션 스레드.
+//       고정 간격 (기본 10ms) 마다 CGameSession::step 을 부르고
+//       그릴 상태를 triple buffer 로 내보냄. 화면은 latest() 로 최근 상태만 읽음.
+//       내보낸 상태가 바뀌었을 때만 setWake() 로 받은 함수를 불러서 잠든 화면을 깨움.
+//       WndProc 입력은 SPSC 큐로 들어와서 시뮬레이션 스레드에서 적용됨.
+//       시작한 뒤에는 세션을 이 스레드만 만짐 (UI 스레드는 stop() 이후에만).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __simThreadH__
+#define __simThreadH__
+
+#include "gameSession.h"
+#include "spscQueue.h"
+#include "tripleBuffer.h"
+#include <atomic>
+#include <thread>
+
+enum GameInputType {
+    INPUT_FIRE,   // VK_SPACE
+    INPUT_AIM,    // 파란공 이동 (dx, dz). 하얀공 턴에만 적용.
+};
+
+struct GameInput {
+    int   type;
+    float dx, dz;
+};
+
+class CSimThread {
+public:
+    explicit CSimThread(CGameSession& session, double tickMs = 10.0);
+    ~CSimThread();
+
+    // 바뀐 snapshot 을 내보낼 때마다 시뮬레이션 스레드에서 부름 (화면 루프를 깨움). start() 전에만.
+    typedef void (*WakeFn)(void* context);
+    void setWake(WakeFn fn, void* context) { m_wake = fn; m_wakeContext = context; }
+
+    void start();
+    void stop();   // 스레드가 끝날 때까지 기다림
+
+    // UI 스레드에서만
+    bool post(const GameInput& input);
+    const GameSnapshot& latest();
+
+private:
+    void run();
+    void apply(const GameInput& input);
+
+    CGameSession&     m_session;
+    double            m_tickMs;
+    std::thread       m_thread;
+    std::atomic<bool> m_running;
+
+    CSpscQueue<GameInput, 64>   m_input;
+    CTripleBuffer<GameSnapshot> m_snapshots;
+    GameSnapshot                m_published;   // 마지막으로 내보낸 상태 (시뮬레이션 스레드만)
+    WakeFn                      m_wake;
+    void*                       m_wakeContext;
+};
+
+#endif // __simThreadH__
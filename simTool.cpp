@@ -0,0 +1,735 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: simTool.cpp
+//
+// Desc: 물리 시뮬레이터 (와 게임 루프의 프레임 스케줄러) 점검용 커맨드라인 도구 (게임과 별도 실행 파일).
+//       빌드 예) cl /O2 /EHsc simTool.cpp billiardSim.cpp simReference.cpp framePacer.cpp
+//                g++ -O2 -std=c++14 -pthread simTool.cpp billiardSim.cpp simReference.cpp framePacer.cpp -o simTool
+//
+//  simTool bench [-n shots] [-seed S]
+//      같은 샷 묶음을 float / double / Fixed 물리로 각각 끝까지 돌려 step 속도 비교.
+//      "runtime" 줄은 같은 값의 테이블 규격을 상수 대신 실행 중에 읽는 g_customTable 로 돌린 것.
+//      "rails" 는 같은 테이블을 선분 쿠션으로, "pool" 은 포켓 jaw 가 있는 POOL_TABLE (float).
+//  simTool agree [-n shots] [-seed S]
+//      golden 샷의 hit 결과를 float 기준으로 double / Fixed 와 비교. 다른 샷은 출력.
+//      golden 샷 = 조준점을 조금 (1e-6 ~ 1e-3) 옮겨도 float hit 가 그대로이고, 치기 전에
+//      딱 붙어 있는 (간격 < 1e-4) 공이 없는 샷. 스치듯 맞거나 붙어 있는 공은 어느 타입이든
+//      반올림 차이로 닿음 여부가 갈리고, 그 차이가 충돌 몇 번 만에 커지므로 뺌.
+//  simTool hash [-n shots] [-seed S]
+//      결정적 모드 (Fixed) 만으로 샷을 이어 치며 매 step 의 공 상태와 hit 를 해시.
+//      조준도 정수 난수와 Fixed 삼각함수로 만들므로, 빌드 (컴파일러, -O 단계, -ffast-math,
+//      -march) 가 달라도 출력이 같아야 함.
+//  simTool golden [-n shots] [-seed S] [-engine E] [-tol T] [-j threads] [-show K]
+//      엔진 (float / double / fixed / runtime, -engine 으로 하나만) 을 고정된 기준 물리
+//      (simReference.h) 와 샷마다 비교: hit, 멈춘 위치 (축마다 T 이내), getScore.
+//      T 기본값은 엔진별 (float 계열 0, double 0.01, fixed 0.1).
+//      샷 묶음은 기준 물리로 만듦 (기본 20000 샷, 시작 배치와 무작위 배치에서 이어 친 것).
+//      golden 샷 (agree 와 같은 기준을 기준 물리로) 에서 다르면 실패. 실패한 샷은 K 개 (기본 3)
+//      까지 처음 달라진 step 과, 배치/조준점을 가능한 한 짧은 소수로 줄여도 여전히 다른 재현
+//      샷을 출력. 그 줄을 그대로 "simTool golden -engine E -shot ..." 으로 다시 돌려 볼 수 있음.
+//  simTool golden -shot "turn x0 z0 x1 z1 x2 z2 x3 z3 tx tz" [-engine E] [-tol T]
+//      샷 하나를 기준과 엔진으로 쳐서 결과와 처음 달라진 step 출력. turn 1: 흰 공, -1: 노란 공.
+//  simTool pacer
+//      CFramePacer (framePacer.h) 의 dirty / animating / keepAwake / 간격 계산을 정해 둔 시각으로
+//      점검. 틀린 항목이 있으면 출력하고 2 반환.
+//
+//  샷 묶음: 시작 배치 (spherePos) 에서 출발해 무작위 샷을 이어 친 배치들과 그 다음 샷.
+//  seed 가 같으면 어느 기기에서나 같은 묶음 (분포 클래스 대신 mt19937 값을 직접 변환).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "billiardSimCore.h"
+#include "simReference.h"
+#include "framePacer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+static const int CHAIN_LENGTH = 8;   // 이만큼 이어 치면 시작 배치로 돌아감
+static const float GOLDEN_NUDGE[] = { 1e-3f, 1e-4f, 1e-5f, 1e-6f };
+static const double GOLDEN_GAP = 1e-4;
+
+struct CorpusShot {
+    SimWorld world;   // 치기 직전 배치 (hit 비움, 모두 정지)
+    int      ball;
+    float    targetX, targetZ;
+};
+
+static void usage() {
+    fprintf(stderr,
+        "usage:\n"
+        "  simTool bench [-n shots] [-seed S]\n"
+        "  simTool agree [-n shots] [-seed S]\n"
+        "  simTool hash [-n shots] [-seed S]\n"
+        "  simTool golden [-n shots] [-seed S] [-engine E] [-tol T] [-j threads] [-show K]\n"
+        "  simTool golden -shot \"turn x0 z0 x1 z1 x2 z2 x3 z3 tx tz\" [-engine E] [-tol T]\n"
+        "  simTool pacer\n");
+}
+
+static double unit(std::mt19937& rng) {
+    return (rng() >> 8) * (1.0 / 16777216.0);
+}
+
+static std::vector<CorpusShot> makeCorpus(int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<CorpusShot> corpus;
+    corpus.reserve(count);
+
+    SimWorld w;
+    int isWhiteTurn = 1;
+    for (int i = 0; i < count; i++) {
+        if (i % CHAIN_LENGTH == 0) {
+            simReset(w);
+            isWhiteTurn = 1;
+        }
+        CorpusShot s;
+        s.world = w;
+        s.ball = isWhiteTurn == 1 ? BALL_WHITE : BALL_YELLOW;
+        double angle = 2 * 3.14159265358979 * unit(rng);
+        double power = 0.5 + 9.5 * unit(rng);
+        const SimBall& b = w.ball[s.ball];
+        s.targetX = (float)(b.x + power * cos(angle));
+        s.targetZ = (float)(b.z + power * sin(angle));
+        corpus.push_back(s);
+
+        // 다음 배치: float 로 쳐서 완전히 멈출 때까지
+        simFire(w, s.ball, s.targetX, s.targetZ);
+        simRun(w);
+        int score = simTurnScore(w, isWhiteTurn);
+        simSettle(w);
+        simClearHits(w);
+        if (score != 1) isWhiteTurn = -isWhiteTurn;
+    }
+    return corpus;
+}
+
+// 샷 하나를 T 로 쳐서 멈출 때까지. 진행한 step 수를 더하고 hit 를 돌려줌.
+template <class T, const TableSpec& S = CAROM_TABLE>
+static void playShot(const CorpusShot& s, unsigned char hit[SIM_BALLS], long long& steps) {
+    SimWorldT<T> w;
+    simcore::convert(s.world, w);
+    simcore::fire(w, s.ball, simcore::C<T>(s.targetX), simcore::C<T>(s.targetZ));
+    steps += simcore::run<S>(w, simcore::C<T>(SIM_TIME_STEP), SIM_MAX_STEPS);
+    memcpy(hit, w.hit, SIM_BALLS);
+}
+
+template <class T, const TableSpec& S = CAROM_TABLE>
+static void benchOne(const char* name, const std::vector<CorpusShot>& corpus) {
+    unsigned char hit[SIM_BALLS];
+    long long steps = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < corpus.size(); i++) playShot<T, S>(corpus[i], hit, steps);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("%-7s %10lld steps %8.1f ms %7.1f ns/step %8.2f Msteps/s\n",
+           name, steps, sec * 1e3, sec * 1e9 / steps, steps / sec * 1e-6);
+}
+
+// 붙어 있는 공이 없고, 조준점을 x, z 로 ±nudge 만큼 옮겨 쳐도 float hit 가 같으면 true
+static bool isGolden(const CorpusShot& s, const unsigned char ref[SIM_BALLS]) {
+    for (int i = 0; i < SIM_BALLS; i++) {
+        for (int j = i + 1; j < SIM_BALLS; j++) {
+            double dx = (double)s.world.ball[i].x - s.world.ball[j].x;
+            double dz = (double)s.world.ball[i].z - s.world.ball[j].z;
+            if (fabs(sqrt(dx * dx + dz * dz) - 2 * SIM_RADIUS) < GOLDEN_GAP) return false;
+        }
+    }
+    for (size_t k = 0; k < sizeof(GOLDEN_NUDGE) / sizeof(GOLDEN_NUDGE[0]); k++) {
+        for (int d = 0; d < 4; d++) {
+            CorpusShot t = s;
+            float nudge = d & 1 ? -GOLDEN_NUDGE[k] : GOLDEN_NUDGE[k];
+            if (d & 2) t.targetZ += nudge;
+            else t.targetX += nudge;
+            unsigned char hit[SIM_BALLS];
+            long long steps = 0;
+            playShot<float>(t, hit, steps);
+            if (memcmp(ref, hit, SIM_BALLS)) return false;
+        }
+    }
+    return true;
+}
+
+template <class T>
+static int agreeOne(const char* name, const std::vector<CorpusShot>& corpus,
+                    const std::vector<bool>& golden) {
+    int mismatch = 0, borderline = 0, total = 0;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        unsigned char ref[SIM_BALLS], hit[SIM_BALLS];
+        long long steps = 0;
+        playShot<float>(corpus[i], ref, steps);
+        playShot<T>(corpus[i], hit, steps);
+        if (!golden[i]) {
+            if (memcmp(ref, hit, SIM_BALLS)) borderline++;
+            continue;
+        }
+        total++;
+        if (!memcmp(ref, hit, SIM_BALLS)) continue;
+        if (++mismatch <= 10) {
+            const CorpusShot& s = corpus[i];
+            printf("  %s shot %d: ball %d target (%.9g, %.9g) hit %02x%02x%02x%02x, float %02x%02x%02x%02x\n",
+                   name, (int)i, s.ball, s.targetX, s.targetZ,
+                   hit[0], hit[1], hit[2], hit[3], ref[0], ref[1], ref[2], ref[3]);
+        }
+    }
+    printf("%-7s %d / %d golden shots differ from float (%d borderline shots differ)\n",
+           name, mismatch, total, borderline);
+    return mismatch;
+}
+
+static bool parseCorpusArgs(int argc, char** argv, int& count, unsigned& seed) {
+    for (int i = 0; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) count = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-seed") && i + 1 < argc) seed = (unsigned)strtoul(argv[++i], NULL, 10);
+        else return false;
+    }
+    return count > 0;
+}
+
+static int cmdBench(int argc, char** argv) {
+    int count = 2000;
+    unsigned seed = 1;
+    if (!parseCorpusArgs(argc, argv, count, seed)) { usage(); return 1; }
+    std::vector<CorpusShot> corpus = makeCorpus(count, seed);
+    benchOne<float>("float", corpus);
+    benchOne<double>("double", corpus);
+    benchOne<Fixed>("fixed", corpus);
+    g_customTable = CAROM_TABLE;
+    benchOne<float, g_customTable>("runtime", corpus);
+    benchOne<float, CAROM_RAIL_TABLE>("rails", corpus);
+    benchOne<float, POOL_TABLE>("pool", corpus);
+    return 0;
+}
+
+static int cmdAgree(int argc, char** argv) {
+    int count = 2000;
+    unsigned seed = 1;
+    if (!parseCorpusArgs(argc, argv, count, seed)) { usage(); return 1; }
+    std::vector<CorpusShot> corpus = makeCorpus(count, seed);
+    std::vector<bool> golden(corpus.size());
+    int goldenCount = 0;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        unsigned char ref[SIM_BALLS];
+        long long steps = 0;
+        playShot<float>(corpus[i], ref, steps);
+        golden[i] = isGolden(corpus[i], ref);
+        goldenCount += golden[i];
+    }
+    printf("%d shots, %d golden\n", (int)corpus.size(), goldenCount);
+
+    int bad = agreeOne<double>("double", corpus, golden);
+    bad += agreeOne<Fixed>("fixed", corpus, golden);
+    return bad ? 2 : 0;
+}
+
+// FNV-1a
+static void hashBytes(unsigned long long& h, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+}
+
+static int cmdHash(int argc, char** argv) {
+    int count = 2000;
+    unsigned seed = 1;
+    if (!parseCorpusArgs(argc, argv, count, seed)) { usage(); return 1; }
+
+    const Fixed dt = Fixed::fromDouble(SIM_TIME_STEP);
+    std::mt19937 rng(seed);
+    unsigned long long h = 14695981039346656037ULL;
+    long long steps = 0;
+    int points = 0;
+    SimWorldT<Fixed> w;
+    int isWhiteTurn = 1;
+    for (int i = 0; i < count; i++) {
+        if (i % CHAIN_LENGTH == 0) {
+            simcore::reset(w);
+            isWhiteTurn = 1;
+        }
+        int ball = isWhiteTurn == 1 ? BALL_WHITE : BALL_YELLOW;
+        // 각도 [0, 2π), 세기 [0.5, 10)
+        Fixed angle = Fixed::fromRaw((int32_t)(rng() % 105414357u));
+        Fixed power = Fixed::fromRaw((int32_t)(8388608u + rng() % 159383552u));
+        Fixed s, c;
+        fixedSinCos(angle, s, c);
+        simcore::fire(w, ball, w.ball[ball].x + power * c, w.ball[ball].z + power * s);
+
+        for (int k = 0; k < SIM_MAX_STEPS && !simcore::allStopped(w); k++) {
+            simcore::step(w, dt);
+            steps++;
+            hashBytes(h, w.ball, sizeof(w.ball));
+            hashBytes(h, w.hit, sizeof(w.hit));
+        }
+
+        // simTurnScore 와 같은 규칙
+        int opponent = ball == BALL_WHITE ? BALL_YELLOW : BALL_WHITE;
+        bool r1 = (w.hit[ball] >> BALL_RED1) & 1;
+        bool r2 = (w.hit[ball] >> BALL_RED2) & 1;
+        bool foul = ((w.hit[ball] >> opponent) & 1) || (!r1 && !r2);
+        if (!foul && r1 && r2) points++;
+        else isWhiteTurn = -isWhiteTurn;
+        simcore::settle(w, dt, SIM_MAX_STEPS);
+        simcore::clearHits(w);
+    }
+    printf("%d shots, %lld steps, %d points, hash %016llx\n", count, steps, points, h);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// golden: 고정된 기준 물리 (simReference.h) 와 엔진 비교
+// -----------------------------------------------------------------------------
+
+struct GoldenShot {
+    simref::World world;   // 치기 직전 배치 (hit 비움, 모두 정지)
+    int   turn;            // 1: 흰 공, -1: 노란 공
+    float targetX, targetZ;
+};
+
+// 샷 하나가 끝난 (또는 샷 중 한 step 뒤의) 상태
+struct GoldenOutcome {
+    float         x[SIM_BALLS], z[SIM_BALLS];
+    unsigned char hit[SIM_BALLS];
+    int           score;   // getScore
+    int           steps;
+};
+
+enum { DIFF_HIT = 1, DIFF_POSITION = 2, DIFF_SCORE = 4 };
+
+static const int    GOLDEN_CORPUS = 20000;
+static const double GOLDEN_TOLERANCE = 0.01;
+static const float  GOLDEN_STABLE_NUDGE = 1e-5f;
+static const double LAYOUT_MARGIN = 0.01;   // 무작위 배치에서 공끼리, 공과 벽 사이 최소 간격
+static const int    REPRO_CANDIDATES = 50;  // 처음 달라진 step 을 찾아 볼 실패 샷 수 (엔진마다)
+
+static int shooterOf(int turn) { return turn == 1 ? BALL_WHITE : BALL_YELLOW; }
+
+static void referenceOutcome(const simref::World& w, int turn, int steps, GoldenOutcome& o) {
+    for (int i = 0; i < SIM_BALLS; i++) {
+        o.x[i] = w.ball[i].x;
+        o.z[i] = w.ball[i].z;
+    }
+    memcpy(o.hit, w.hit, SIM_BALLS);
+    o.score = simref::turnScore(w, turn);
+    o.steps = steps;
+}
+
+// trace 가 있으면 step 마다의 상태도 넣음
+static void playReference(const GoldenShot& s, GoldenOutcome& out, std::vector<GoldenOutcome>* trace) {
+    simref::World w = s.world;
+    simref::fire(w, shooterOf(s.turn), s.targetX, s.targetZ);
+    int steps = 0;
+    while (steps < simref::MAX_STEPS && !simref::allStopped(w)) {
+        simref::step(w, simref::TIME_STEP);
+        steps++;
+        if (trace) {
+            trace->push_back(GoldenOutcome());
+            referenceOutcome(w, s.turn, steps, trace->back());
+        }
+    }
+    referenceOutcome(w, s.turn, steps, out);
+}
+
+// 엔진 쪽 점수는 게임이 쓰는 simTurnScore 로
+template <class T>
+static void engineOutcome(const SimWorldT<T>& w, int turn, int steps, GoldenOutcome& o) {
+    SimWorld f;
+    simcore::convert(w, f);
+    for (int i = 0; i < SIM_BALLS; i++) {
+        o.x[i] = f.ball[i].x;
+        o.z[i] = f.ball[i].z;
+    }
+    memcpy(o.hit, f.hit, SIM_BALLS);
+    o.score = simTurnScore(f, turn);
+    o.steps = steps;
+}
+
+template <class T, const TableSpec& S>
+static void playEngine(const GoldenShot& s, GoldenOutcome& out, std::vector<GoldenOutcome>* trace) {
+    SimWorldT<T> w;
+    simcore::reset<S>(w);
+    for (int i = 0; i < SIM_BALLS; i++) {
+        w.ball[i].x = simcore::C<T>(s.world.ball[i].x);
+        w.ball[i].z = simcore::C<T>(s.world.ball[i].z);
+    }
+    const T dt = simcore::C<T>(SIM_TIME_STEP);
+    simcore::fire(w, shooterOf(s.turn), simcore::C<T>(s.targetX), simcore::C<T>(s.targetZ));
+    int steps = 0;
+    while (steps < SIM_MAX_STEPS && !simcore::allStopped<S>(w)) {
+        simcore::step<S>(w, dt);
+        steps++;
+        if (trace) {
+            trace->push_back(GoldenOutcome());
+            engineOutcome(w, s.turn, steps, trace->back());
+        }
+    }
+    engineOutcome(w, s.turn, steps, out);
+}
+
+typedef void (*GoldenPlay)(const GoldenShot&, GoldenOutcome&, std::vector<GoldenOutcome>*);
+
+struct GoldenEngine {
+    const char* name;
+    GoldenPlay  play;
+    double      tolerance;   // 멈춘 위치 허용 오차 (-tol 로 바꿈)
+};
+
+// 같은 4 구 테이블 (CAROM_TABLE 벽) 을 계산하는 엔진들. 새 엔진은 여기에 더함.
+// float 엔진은 기준과 같은 계산 순서라 비트까지 같아야 함. Fixed 는 매 step 의 Q8.24 반올림이
+// 기준의 golden 안정성 검사 (1e-5) 보다 크게 쌓이므로 허용 오차를 넓게: 60000 샷 (seed 1, 7) 에서
+// 최대 0.038 이라 0.1. 넘으면 다른 엔진과 똑같이 실패.
+static const GoldenEngine GOLDEN_ENGINES[] = {
+    { "float", playEngine<float, CAROM_TABLE>, 0 },
+    { "double", playEngine<double, CAROM_TABLE>, 0.01 },
+    { "fixed", playEngine<Fixed, CAROM_TABLE>, 0.1 },
+    { "runtime", playEngine<float, g_customTable>, 0 },
+};
+static const int GOLDEN_ENGINE_COUNT = sizeof(GOLDEN_ENGINES) / sizeof(GOLDEN_ENGINES[0]);
+
+static unsigned compareOutcome(const GoldenOutcome& ref, const GoldenOutcome& o, double tol, double& err) {
+    unsigned diff = 0;
+    err = 0;
+    for (int i = 0; i < SIM_BALLS; i++) {
+        err = std::max(err, fabs((double)o.x[i] - ref.x[i]));
+        err = std::max(err, fabs((double)o.z[i] - ref.z[i]));
+    }
+    if (err > tol) diff |= DIFF_POSITION;
+    if (memcmp(ref.hit, o.hit, SIM_BALLS)) diff |= DIFF_HIT;
+    if (ref.score != o.score) diff |= DIFF_SCORE;
+    return diff;
+}
+
+// 벽에서 margin, 공끼리 2R + margin 이상 떨어진 무작위 배치
+static void randomLayout(simref::World& w, std::mt19937& rng) {
+    const double rangeX = 4.5 - SIM_RADIUS - LAYOUT_MARGIN;
+    const double rangeZ = 3.0 - SIM_RADIUS - LAYOUT_MARGIN;
+    for (int i = 0; i < SIM_BALLS; i++) {
+        bool ok;
+        do {
+            w.ball[i].x = (float)((2 * unit(rng) - 1) * rangeX);
+            w.ball[i].z = (float)((2 * unit(rng) - 1) * rangeZ);
+            ok = true;
+            for (int j = 0; j < i; j++) {
+                double dx = (double)w.ball[i].x - w.ball[j].x, dz = (double)w.ball[i].z - w.ball[j].z;
+                ok = ok && sqrt(dx * dx + dz * dz) >= 2 * SIM_RADIUS + LAYOUT_MARGIN;
+            }
+        } while (!ok);
+        w.ball[i].vx = w.ball[i].vz = 0;
+    }
+    simref::clearHits(w);
+}
+
+// 이어 치기 묶음마다 짝수 번째는 시작 배치 (spherePos), 홀수 번째는 무작위 배치에서 시작.
+// 다음 배치는 기준 물리로 쳐서 완전히 멈춘 것이므로 어느 엔진과도 상관없음.
+static std::vector<GoldenShot> makeGoldenCorpus(int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<GoldenShot> corpus;
+    corpus.reserve(count);
+
+    simref::World w;
+    int turn = 1;
+    for (int i = 0; i < count; i++) {
+        if (i % CHAIN_LENGTH == 0) {
+            if ((i / CHAIN_LENGTH) % 2 == 0) simref::reset(w);
+            else randomLayout(w, rng);
+            turn = 1;
+        }
+        GoldenShot s;
+        s.world = w;
+        s.turn = turn;
+        double angle = 2 * 3.14159265358979 * unit(rng);
+        double power = 0.5 + 9.5 * unit(rng);
+        const simref::Ball& b = w.ball[shooterOf(turn)];
+        s.targetX = (float)(b.x + power * cos(angle));
+        s.targetZ = (float)(b.z + power * sin(angle));
+        corpus.push_back(s);
+
+        simref::fire(w, shooterOf(turn), s.targetX, s.targetZ);
+        simref::run(w);
+        int score = simref::turnScore(w, turn);
+        simref::settle(w);
+        simref::clearHits(w);
+        if (score != 1) turn = -turn;
+    }
+    return corpus;
+}
+
+// agree 의 golden 기준을 기준 물리로: 붙어 있는 공이 없고, 조준점을 조금 옮겨도 hit 가 같은 샷.
+// 위치도 비교하므로 반올림 수준 (GOLDEN_STABLE_NUDGE 이하) 으로 옮겼을 때 멈춘 위치가 tol 안인 샷만.
+// (여러 번 부딪히며 작은 차이가 크게 벌어지는 샷은 double / Fixed 의 반올림만으로도 위치가 갈림)
+static bool isGoldenShot(const GoldenShot& s, const GoldenOutcome& ref, double tol) {
+    for (int i = 0; i < SIM_BALLS; i++) {
+        for (int j = i + 1; j < SIM_BALLS; j++) {
+            double dx = (double)s.world.ball[i].x - s.world.ball[j].x;
+            double dz = (double)s.world.ball[i].z - s.world.ball[j].z;
+            if (fabs(sqrt(dx * dx + dz * dz) - 2 * SIM_RADIUS) < GOLDEN_GAP) return false;
+        }
+    }
+    for (size_t k = 0; k < sizeof(GOLDEN_NUDGE) / sizeof(GOLDEN_NUDGE[0]); k++) {
+        for (int d = 0; d < 4; d++) {
+            GoldenShot t = s;
+            float nudge = d & 1 ? -GOLDEN_NUDGE[k] : GOLDEN_NUDGE[k];
+            if (d & 2) t.targetZ += nudge;
+            else t.targetX += nudge;
+            GoldenOutcome o;
+            double err;
+            playReference(t, o, NULL);
+            unsigned diff = compareOutcome(ref, o, tol, err);
+            if (diff & DIFF_HIT) return false;
+            if ((diff & DIFF_POSITION) && GOLDEN_NUDGE[k] <= GOLDEN_STABLE_NUDGE) return false;
+        }
+    }
+    return true;
+}
+
+// 기준과 처음 달라진 (hit 또는 위치) step. 끝까지 같으면 0.
+static int firstDivergence(const GoldenShot& s, GoldenPlay play, double tol) {
+    std::vector<GoldenOutcome> a, b;
+    GoldenOutcome ra, rb;
+    playReference(s, ra, &a);
+    play(s, rb, &b);
+    double err;
+    size_t n = std::min(a.size(), b.size());
+    for (size_t k = 0; k < n; k++) {
+        if (compareOutcome(a[k], b[k], tol, err) & (DIFF_HIT | DIFF_POSITION)) return (int)k + 1;
+    }
+    if (a.size() != b.size()) return (int)n + 1;   // 한쪽이 먼저 멈춤
+    return compareOutcome(ra, rb, tol, err) ? (int)n : 0;
+}
+
+// 배치와 조준점을 소수 digits 자리로 반올림한 샷. 공이 겹치게 되면 false.
+static bool roundShot(const GoldenShot& s, int digits, GoldenShot& out) {
+    double scale = pow(10.0, digits);
+    out = s;
+    for (int i = 0; i < SIM_BALLS; i++) {
+        out.world.ball[i].x = (float)(floor(s.world.ball[i].x * scale + 0.5) / scale);
+        out.world.ball[i].z = (float)(floor(s.world.ball[i].z * scale + 0.5) / scale);
+        for (int j = 0; j < i; j++) {
+            double dx = (double)out.world.ball[i].x - out.world.ball[j].x;
+            double dz = (double)out.world.ball[i].z - out.world.ball[j].z;
+            if (sqrt(dx * dx + dz * dz) < 2 * SIM_RADIUS) return false;
+        }
+    }
+    out.targetX = (float)(floor(s.targetX * scale + 0.5) / scale);
+    out.targetZ = (float)(floor(s.targetZ * scale + 0.5) / scale);
+    return true;
+}
+
+// 가장 짧은 소수로 줄여도 golden 이면서 같은 종류로 달라지는 샷. digits 에 자릿수 (못 줄이면 -1).
+static GoldenShot minimalRepro(const GoldenShot& s, GoldenPlay play, double tol, double goldenTol, unsigned kind,
+                               int& digits) {
+    for (digits = 1; digits <= 6; digits++) {
+        GoldenShot t;
+        if (!roundShot(s, digits, t)) continue;
+        GoldenOutcome ref, o;
+        double err;
+        playReference(t, ref, NULL);
+        play(t, o, NULL);
+        if ((compareOutcome(ref, o, tol, err) & kind) && isGoldenShot(t, ref, goldenTol)) return t;
+    }
+    digits = -1;
+    return s;
+}
+
+static void printShot(const GoldenShot& s, int digits) {
+    int p = digits > 0 ? digits : 9;
+    const char* f = digits > 0 ? " %.*f" : " %.*g";
+    printf("\"%d", s.turn);
+    for (int i = 0; i < SIM_BALLS; i++) {
+        printf(f, p, s.world.ball[i].x);
+        printf(f, p, s.world.ball[i].z);
+    }
+    printf(f, p, s.targetX);
+    printf(f, p, s.targetZ);
+    printf("\"");
+}
+
+static void printOutcome(const char* name, const GoldenOutcome& o) {
+    printf("  %-9s steps %5d hit %02x%02x%02x%02x score %2d  at", name, o.steps,
+           o.hit[0], o.hit[1], o.hit[2], o.hit[3], o.score);
+    for (int i = 0; i < SIM_BALLS; i++) printf(" (%.4f, %.4f)", o.x[i], o.z[i]);
+    printf("\n");
+}
+
+// 일을 threads 개 스레드가 나눠 가져감
+template <class Fn>
+static void forEachShot(int count, int threads, const Fn& fn) {
+    std::atomic<int> next(0);
+    auto work = [&] {
+        int i;
+        while ((i = next.fetch_add(1)) < count) fn(i);
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(work);
+    work();
+    for (auto& t : pool) t.join();
+}
+
+static int goldenReplay(const char* text, const std::vector<int>& engines, double tol) {
+    const double goldenTol = tol >= 0 ? tol : GOLDEN_TOLERANCE;
+    GoldenShot s;
+    float v[10];
+    int turn;
+    if (sscanf(text, "%d %f %f %f %f %f %f %f %f %f %f", &turn, &v[0], &v[1], &v[2], &v[3], &v[4], &v[5],
+               &v[6], &v[7], &v[8], &v[9]) != 11 || (turn != 1 && turn != -1)) {
+        usage();
+        return 1;
+    }
+    s.turn = turn;
+    for (int i = 0; i < SIM_BALLS; i++) {
+        s.world.ball[i].x = v[2 * i];
+        s.world.ball[i].z = v[2 * i + 1];
+        s.world.ball[i].vx = s.world.ball[i].vz = 0;
+    }
+    simref::clearHits(s.world);
+    s.targetX = v[8];
+    s.targetZ = v[9];
+
+    GoldenOutcome ref;
+    playReference(s, ref, NULL);
+    printf("golden shot: %s\n", isGoldenShot(s, ref, goldenTol) ? "yes" : "no (borderline)");
+    printOutcome("reference", ref);
+    int bad = 0;
+    for (size_t e = 0; e < engines.size(); e++) {
+        const GoldenEngine& engine = GOLDEN_ENGINES[engines[e]];
+        const double engineTol = tol >= 0 ? tol : engine.tolerance;
+        GoldenOutcome o;
+        double err;
+        engine.play(s, o, NULL);
+        printOutcome(engine.name, o);
+        unsigned diff = compareOutcome(ref, o, engineTol, err);
+        if (!diff) continue;
+        bad++;
+        printf("    %s%s%sdiffers, position error %.3g, first different step %d\n",
+               diff & DIFF_HIT ? "hit " : "", diff & DIFF_POSITION ? "position " : "",
+               diff & DIFF_SCORE ? "score " : "", err, firstDivergence(s, engine.play, engineTol));
+    }
+    return bad ? 2 : 0;
+}
+
+static int cmdGolden(int argc, char** argv) {
+    int count = GOLDEN_CORPUS, show = 3;
+    unsigned seed = 1;
+    double tol = -1;   // 엔진별 기본값
+    int threads = (int)std::thread::hardware_concurrency();
+    const char* engineName = NULL;
+    const char* shot = NULL;
+    for (int i = 0; i < argc; i++) {
+        bool more = i + 1 < argc;
+        if (!strcmp(argv[i], "-n") && more) count = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-seed") && more) seed = (unsigned)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "-engine") && more) engineName = argv[++i];
+        else if (!strcmp(argv[i], "-tol") && more) tol = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-j") && more) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-show") && more) show = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-shot") && more) shot = argv[++i];
+        else { usage(); return 1; }
+    }
+    if (count <= 0) { usage(); return 1; }
+    if (threads < 1) threads = 1;
+
+    g_customTable = CAROM_TABLE;
+    std::vector<int> engines;
+    for (int e = 0; e < GOLDEN_ENGINE_COUNT; e++) {
+        if (!engineName || !strcmp(engineName, GOLDEN_ENGINES[e].name)) engines.push_back(e);
+    }
+    if (engines.empty()) {
+        fprintf(stderr, "unknown engine %s (float, double, fixed, runtime)\n", engineName);
+        return 1;
+    }
+    if (shot) return goldenReplay(shot, engines, tol);
+    const double goldenTol = tol >= 0 ? tol : GOLDEN_TOLERANCE;
+
+    std::vector<GoldenShot> corpus = makeGoldenCorpus(count, seed);
+
+    // 샷마다: 기준 결과, golden 여부, 엔진별 차이
+    const int E = (int)engines.size();
+    std::vector<char> golden(count);
+    std::vector<unsigned> diff((size_t)count * E);
+    std::vector<double> error((size_t)count * E);
+    auto t0 = std::chrono::steady_clock::now();
+    forEachShot(count, threads, [&](int i) {
+        GoldenOutcome ref;
+        playReference(corpus[i], ref, NULL);
+        golden[i] = isGoldenShot(corpus[i], ref, goldenTol);
+        for (int e = 0; e < E; e++) {
+            const GoldenEngine& engine = GOLDEN_ENGINES[engines[e]];
+            GoldenOutcome o;
+            engine.play(corpus[i], o, NULL);
+            diff[(size_t)i * E + e] = compareOutcome(ref, o, tol >= 0 ? tol : engine.tolerance,
+                                                     error[(size_t)i * E + e]);
+        }
+    });
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    int goldenCount = 0;
+    for (int i = 0; i < count; i++) goldenCount += golden[i];
+    printf("%d shots (%d golden), %d threads, %.1f s\n", count, goldenCount, threads, sec);
+
+    int bad = 0;
+    for (int e = 0; e < E; e++) {
+        const GoldenEngine& engine = GOLDEN_ENGINES[engines[e]];
+        const double engineTol = tol >= 0 ? tol : engine.tolerance;
+        int failed = 0, hits = 0, positions = 0, scores = 0, borderline = 0;
+        double maxError = 0;
+        std::vector<int> failures;
+        for (int i = 0; i < count; i++) {
+            unsigned d = diff[(size_t)i * E + e];
+            if (!golden[i]) {
+                borderline += d != 0;
+                continue;
+            }
+            maxError = std::max(maxError, error[(size_t)i * E + e]);
+            if (!d) continue;
+            failed++;
+            hits += (d & DIFF_HIT) != 0;
+            positions += (d & DIFF_POSITION) != 0;
+            scores += (d & DIFF_SCORE) != 0;
+            if ((int)failures.size() < REPRO_CANDIDATES) failures.push_back(i);
+        }
+        printf("%-7s %d / %d golden shots differ (hit %d, position %d, score %d), max position error %.3g "
+               "(tolerance %g); %d / %d borderline shots differ\n",
+               engine.name, failed, goldenCount, hits, positions, scores, maxError, engineTol, borderline,
+               count - goldenCount);
+        bad += failed;
+
+        // 가장 일찍 달라지는 샷부터 줄여서 출력
+        std::vector<std::pair<int, int> > order;
+        for (size_t k = 0; k < failures.size(); k++)
+            order.push_back(std::make_pair(firstDivergence(corpus[failures[k]], engine.play, engineTol), failures[k]));
+        std::sort(order.begin(), order.end());
+        for (int k = 0; k < (int)order.size() && k < show; k++) {
+            int i = order[k].second;
+            unsigned d = diff[(size_t)i * E + e];
+            int digits;
+            GoldenShot repro = minimalRepro(corpus[i], engine.play, engineTol, goldenTol, d, digits);
+            printf("  shot %d: %s%s%sdiffers from step %d. repro: simTool golden -engine %s -shot ", i,
+                   d & DIFF_HIT ? "hit " : "", d & DIFF_POSITION ? "position " : "",
+                   d & DIFF_SCORE ? "score " : "", order[k].first, engine.name);
+            printShot(repro, digits);
+            printf("\n");
+        }
+    }
+    return bad ? 2 : 0;
+}
+
+static int cmdPacer() {
+    int bad = framePacerSelfCheck(stdout);
+    printf("pacer: %s\n", bad ? "FAIL" : "ok");
+    return bad ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { usage(); return 1; }
+    if (!strcmp(argv[1], "bench")) return cmdBench(argc - 2, argv + 2);
+    if (!strcmp(argv[1], "agree")) return cmdAgree(argc - 2, argv + 2);
+    if (!strcmp(argv[1], "hash")) return cmdHash(argc - 2, argv + 2);
+    if (!strcmp(argv[1], "golden")) return cmdGolden(argc - 2, argv + 2);
+    if (!strcmp(argv[1], "pacer")) return cmdPacer();
+    usage();
+    return 1;
+}
@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: spscQueue.h
+//
+// Desc: 생산자 하나, 소비자 하나용 lock-free 고정 크기 큐.
+//       WndProc (UI 스레드) 의 입력을 시뮬레이션 스레드로 넘길 때 사용.
+//       N 은 2 의 거듭제곱. 가득 차면 push 가 false 를 반환함 (입력을 버림).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __spscQueueH__
+#define __spscQueueH__
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t N>
+class CSpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+    CSpscQueue() : m_head(0), m_tail(0) {}
+
+    // 생산자 스레드에서만
+    bool push(const T& item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == N) return false;
+        m_items[tail & (N - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 소비자 스레드에서만
+    bool pop(T& item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        item = m_items[head & (N - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // head/tail 을 다른 캐시 라인에 두어서 두 스레드가 서로의 라인을 건드리지 않도록
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+    alignas(64) T m_items[N];
+};
+
+#endif // __spscQueueH__
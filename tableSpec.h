@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: tableSpec.h
+//
+// Desc: 테이블 규격 (크기, 쿠션 두께, 공 반지름, 공 수, 감속). 물리 (billiardSimCore.h),
+//       조준선, 상태 bin 이 모두 여기서 값을 가져감.
+//       물리는 규격을 템플릿 인자 (const TableSpec&) 로 받으므로 constexpr 규격 (CAROM_TABLE 등)
+//       으로 만들면 값이 모두 상수로 접혀 들어가고, 실험용으로 실행 중에 바꾸는 규격
+//       (g_customTable) 도 같은 코드로 돌릴 수 있음.
+//       쿠션은 두 가지: rails 가 없으면 원래 게임의 네 벽 (CWall::hitBy 와 같은 축 반사),
+//       있으면 선분 목록 (RailSegment) 으로 된 쿠션 면. 포켓 입구 (jaw) 나 직사각형이
+//       아닌 테이블도 선분으로 표현함.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __tableSpecH__
+#define __tableSpecH__
+
+// 쿠션 면 한 조각 (a -> b). 쿠션들은 반시계 방향으로 닫힌 다각형을 이루고 공은 진행 방향의 왼쪽.
+// 각 조각의 시작점 a 가 안쪽으로 튀어나온 꼭짓점 (포켓 jaw 끝) 이면 tip 에서 모서리 충돌도 검사.
+struct RailSegment {
+    double ax, az;
+    double ux, uz;       // a -> b 단위 방향
+    double nx, nz;       // 공 쪽 법선 (u 를 반시계로 90도)
+    double length;
+    double prevX, prevZ; // 앞 조각의 단위 방향 (tip 검사 범위)
+    bool   tip;          // a 가 튀어나온 꼭짓점 (앞 조각에서 오른쪽으로 꺾임)
+};
+
+constexpr double railSqrt(double v)
+{
+    double r = v > 1 ? v : 1;
+    for (int i = 0; i < 64; i++) r = (r + v / r) / 2;
+    return r;
+}
+
+// 꼭짓점 p -> a -> b 에서 a -> b 조각
+constexpr RailSegment railSegment(const double (&p)[2], const double (&a)[2], const double (&b)[2])
+{
+    double length = railSqrt((b[0] - a[0]) * (b[0] - a[0]) + (b[1] - a[1]) * (b[1] - a[1]));
+    double prev = railSqrt((a[0] - p[0]) * (a[0] - p[0]) + (a[1] - p[1]) * (a[1] - p[1]));
+    double ux = (b[0] - a[0]) / length, uz = (b[1] - a[1]) / length;
+    double px = (a[0] - p[0]) / prev, pz = (a[1] - p[1]) / prev;
+    return RailSegment{ a[0], a[1], ux, uz, -uz, ux, length, px, pz, px * uz - pz * ux < 0 };
+}
+
+template <int N>
+struct RailLoop {
+    RailSegment seg[N];
+};
+
+// 반시계 방향 꼭짓점 목록 -> 닫힌 쿠션
+template <int N>
+constexpr RailLoop<N> railLoop(const double (&v)[N][2])
+{
+    RailLoop<N> loop{};
+    for (int i = 0; i < N; i++) loop.seg[i] = railSegment(v[(i + N - 1) % N], v[i], v[(i + 1) % N]);
+    return loop;
+}
+
+struct TableSpec {
+    double halfX, halfZ;   // 중심에서 쿠션 안쪽 면까지
+    double cushion;        // 쿠션 (벽) 두께
+    double radius;         // 공 반지름
+    int    balls;          // 쓰는 공 수 (SimWorld 의 공 배열 크기 SIM_BALLS 이하)
+    double decreaseRate;   // DECREASE_RATE (10ms 당 감속 비율)
+    double stateBin;       // Q-table 상태의 좌표 칸 크기
+    // 선분 쿠션 (railCount 가 0 이면 원래의 네 벽). 선분은 모두 halfX × halfZ 직사각형의 경계나 그 바깥에 있어야 함
+    // (직사각형 안쪽으로 반지름 이상 들어와 있는 공은 쿠션 검사를 건너뜀).
+    const RailSegment* rails;
+    int    railCount;
+
+    // 공 중심이 갈 수 있는 범위 (ballUpdate 의 위치 보정)
+    constexpr double xMax() const { return halfX - radius; }
+    constexpr double zMax() const { return halfZ - radius; }
+    // 쿠션 (CWall) 중심 좌표
+    constexpr double wallX() const { return halfX + cushion / 2; }
+    constexpr double wallZ() const { return halfZ + cushion / 2; }
+};
+
+// 4구 테이블의 쿠션 면
+constexpr double CAROM_RAIL_CORNERS[4][2] = { {-4.5, -3.0}, {4.5, -3.0}, {4.5, 3.0}, {-4.5, 3.0} };
+constexpr RailLoop<4> CAROM_RAILS = railLoop(CAROM_RAIL_CORNERS);
+
+// 포켓볼 테이블 (±5 / ±2.5) 의 쿠션. 구석 포켓은 쿠션이 구석에서 0.5 앞에서 끝나고 45도 jaw 로
+// 0.3 들어간 뒤 막힘, 가운데 포켓은 폭 0.7, 깊이 0.3. 공을 빼는 규칙은 없어서 포켓에 들어간 공은
+// 그 안에서 멈춤.
+constexpr double POOL_RAIL_CORNERS[24][2] = {
+    {-5.3, -2.3}, {-4.8, -2.8}, {-4.5, -2.5},                 // 왼쪽 아래 포켓
+    {-0.35, -2.5}, {-0.35, -2.8}, {0.35, -2.8}, {0.35, -2.5}, // 아래 가운데 포켓
+    {4.5, -2.5}, {4.8, -2.8}, {5.3, -2.3}, {5.0, -2.0},       // 오른쪽 아래 포켓
+    {5.0, 2.0}, {5.3, 2.3}, {4.8, 2.8}, {4.5, 2.5},           // 오른쪽 위 포켓
+    {0.35, 2.5}, {0.35, 2.8}, {-0.35, 2.8}, {-0.35, 2.5},     // 위 가운데 포켓
+    {-4.5, 2.5}, {-4.8, 2.8}, {-5.3, 2.3}, {-5.0, 2.0},       // 왼쪽 위 포켓
+    {-5.0, -2.0},
+};
+constexpr RailLoop<24> POOL_RAILS = railLoop(POOL_RAIL_CORNERS);
+
+// 게임이 쓰는 4구 테이블 (원래 코드의 ±4.5 / ±3, 벽 ±4.56 / ±3.06, 두께 0.12, M_RADIUS)
+constexpr TableSpec CAROM_TABLE = { 4.5, 3.0, 0.12, 0.21, 4, 0.9982, 0.5, nullptr, 0 };
+// 같은 4구 테이블을 선분 쿠션으로 (구석에서 두 쿠션을 모두 처리)
+constexpr TableSpec CAROM_RAIL_TABLE = { 4.5, 3.0, 0.12, 0.21, 4, 0.9982, 0.5, CAROM_RAILS.seg, 4 };
+// 포켓볼 비율 (2:1) 의 큰 테이블, 포켓 jaw 포함
+constexpr TableSpec POOL_TABLE = { 5.0, 2.5, 0.12, 0.21, 4, 0.9982, 0.5, POOL_RAILS.seg, 24 };
+
+// 실행 중에 바꿔 쓰는 규격 (실험용, 처음에는 CAROM_TABLE). 물리에 넘기면 매번 메모리에서 읽음.
+extern TableSpec g_customTable;
+
+#endif // __tableSpecH__
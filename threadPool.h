@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: threadPool.h
+//
+// Desc: 고정 크기 스레드 풀. AI 탐색처럼 서로 독립적인 시뮬레이션을 나눠 돌릴 때 사용.
+//       parallelFor 는 부른 스레드도 같이 일을 가져가므로 작업 안에서 다시 불러도 멈추지 않음.
+//       parallelFor 는 힙을 쓰지 않음 (작업 정보는 부른 쪽 스택에, 함수는 포인터로 넘김).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __threadPoolH__
+#define __threadPoolH__
+
+#include "trace.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CThreadPool {
+public:
+    // threads <= 0 이면 (코어 수 - 1) 개. 0 개여도 parallelFor 는 부른 스레드에서 돎.
+    explicit CThreadPool(int threads = -1)
+    {
+        if (threads < 0) {
+            int hw = (int)std::thread::hardware_concurrency();
+            threads = hw > 1 ? hw - 1 : 0;
+        }
+        m_stop = false;
+        m_jobs = NULL;
+        for (int i = 0; i < threads; i++)
+            m_workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ~CThreadPool(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& t : m_workers) t.join();
+    }
+
+    int size(void) const { return (int)m_workers.size(); }
+
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_cv.notify_one();
+    }
+
+    // fn(0) ~ fn(n-1) 을 나눠서 실행하고 모두 끝날 때까지 기다림
+    template <typename Fn>
+    void parallelFor(int n, const Fn& fn)
+    {
+        if (n <= 0) return;
+        Job job;
+        job.next = 0;
+        job.n = n;
+        job.helpers = 0;
+        job.fn = &fn;
+        job.call = [](const void* f, int i) { (*static_cast<const Fn*>(f))(i); };
+
+        // 목록에 있는 동안 쉬는 worker 가 와서 같이 가져감
+        bool helped = !m_workers.empty() && n > 1;
+        if (helped) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                job.link = m_jobs;
+                m_jobs = &job;
+            }
+            m_cv.notify_all();
+        }
+        runJob(job);
+        if (!helped) return;
+
+        // 목록에서 빼면 새로 오는 worker 는 없음. 이미 가져간 항목을 끝낼 때까지만 기다림.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (Job** p = &m_jobs; *p; p = &(*p)->link) {
+            if (*p == &job) {
+                *p = job.link;
+                break;
+            }
+        }
+        job.cv.wait(lock, [&] { return job.helpers == 0; });
+    }
+
+private:
+    struct Job {
+        std::atomic<int>        next;
+        int                     n;
+        int                     helpers;   // 이 작업을 돌고 있는 worker 수 (m_mutex)
+        const void*             fn;
+        void                  (*call)(const void* fn, int i);
+        Job*                    link;      // m_jobs 목록
+        std::condition_variable cv;
+    };
+
+    static void runJob(Job& job)
+    {
+        TRACE_SCOPE("parallelFor");
+        int i;
+        while ((i = job.next.fetch_add(1)) < job.n) job.call(job.fn, i);
+    }
+
+    // 아직 나눠 줄 항목이 남은 작업 (m_mutex 를 잡고)
+    Job* openJob(void) const
+    {
+        for (Job* j = m_jobs; j; j = j->link) {
+            if (j->next.load(std::memory_order_relaxed) < j->n) return j;
+        }
+        return NULL;
+    }
+
+    void workerLoop(void)
+    {
+        traceThreadName("pool worker");
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            Job* job = NULL;
+            m_cv.wait(lock, [&] { return m_stop || (job = openJob()) != NULL || !m_tasks.empty(); });
+            // parallelFor 를 먼저 (부른 스레드가 기다리고 있음)
+            if (job) {
+                job->helpers++;
+                lock.unlock();
+                runJob(*job);
+                lock.lock();
+                if (--job->helpers == 0) job->cv.notify_one();
+                continue;
+            }
+            if (m_stop && m_tasks.empty()) return;
+            std::function<void()> task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::vector<std::thread>          m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    Job*                              m_jobs;   // 진행 중인 parallelFor (부른 쪽 스택에 있음)
+    std::mutex                        m_mutex;
+    std::condition_variable           m_cv;
+    bool                              m_stop;
+};
+
+#endif // __threadPoolH__
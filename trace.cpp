@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: trace.cpp
+//
+// Desc: 스레드별 trace ring 목록과 Chrome trace JSON 출력 (USE_TRACE 빌드만)
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "trace.h"
+
+#ifdef USE_TRACE
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+typedef std::chrono::steady_clock TraceClock;
+
+std::atomic<bool> g_traceOn(false);
+
+static std::mutex   s_traceMutex;
+static TraceBuffer* s_traceBuffers = NULL;   // 스레드가 끝나도 지우지 않음 (쓸 때까지 보관)
+static int          s_traceThreads = 0;
+
+// tick -> us 환산용 기준점 (traceStart 와 traceWrite 때의 tick 과 시계)
+static uint64_t              s_startTicks;
+static TraceClock::time_point s_startTime;
+
+// 할당 검사 (allocTrack.h) 구간 안에서 처음 불려도 걸리지 않게 operator new 대신 malloc
+TraceBuffer* traceRegisterThread()
+{
+    TraceBuffer* b = new (malloc(sizeof(TraceBuffer))) TraceBuffer;
+    b->count.store(0, std::memory_order_relaxed);
+    b->threadName = NULL;
+    std::lock_guard<std::mutex> lock(s_traceMutex);
+    b->tid = ++s_traceThreads;
+    b->next = s_traceBuffers;
+    s_traceBuffers = b;
+    return b;
+}
+
+void traceStart()
+{
+    s_startTicks = traceTicks();
+    s_startTime = TraceClock::now();
+    g_traceOn.store(true, std::memory_order_relaxed);
+}
+
+void traceStop()
+{
+    g_traceOn.store(false, std::memory_order_relaxed);
+}
+
+void traceThreadName(const char* name)
+{
+    traceThreadBuffer()->threadName = name;
+}
+
+bool traceWrite(const char* path)
+{
+    // 시작부터 지금까지의 tick 수와 실제 시간으로 tick 당 us
+    uint64_t endTicks = traceTicks();
+    double us = std::chrono::duration<double, std::micro>(TraceClock::now() - s_startTime).count();
+    double usPerTick = endTicks > s_startTicks && us > 0 ? us / (double)(endTicks - s_startTicks) : 1e-3;
+
+    FILE* fp = fopen(path, "w");
+    if (!fp) return false;
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(s_traceMutex);
+    for (const TraceBuffer* b = s_traceBuffers; b; b = b->next) {
+        if (b->threadName) {
+            fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    first ? "" : ",\n", b->tid, b->threadName);
+            first = false;
+        }
+        // ring 이 돌았으면 남아 있는 마지막 TRACE_CAPACITY 개만
+        uint64_t count = b->count.load(std::memory_order_acquire);
+        uint64_t from = count > (uint64_t)TRACE_CAPACITY ? count - TRACE_CAPACITY : 0;
+        for (uint64_t n = from; n < count; n++) {
+            const TraceRecord& r = b->records[n & (TRACE_CAPACITY - 1)];
+            if (r.start < s_startTicks) continue;   // 전에 켰을 때의 기록
+            double ts = (double)(r.start - s_startTicks) * usPerTick;
+            if (r.kind == TRACE_SPAN)
+                fprintf(fp, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        first ? "" : ",\n", r.name, b->tid, ts, (double)r.value * usPerTick);
+            else
+                fprintf(fp, "%s{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                        first ? "" : ",\n", r.name, b->tid, ts, (long long)r.value);
+            first = false;
+        }
+    }
+    fprintf(fp, "\n]}\n");
+    return fclose(fp) == 0;
+}
+
+#endif // USE_TRACE
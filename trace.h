@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: trace.h
+//
+// Desc: 스레드 사이의 대기/경합을 보기 위한 구간 (span) 과 카운터 기록.
+//       USE_TRACE 로 빌드할 때만 켜지고, 아니면 매크로가 모두 빈 문장이라 비용이 없음.
+//       스레드마다 고정 크기 ring 에 기록 (가득 차면 오래된 것부터 덮어씀, 잠금 없음).
+//       traceStart() 이후에만 기록하고, traceWrite() 로 Chrome trace JSON 을 씀
+//       (chrome://tracing, ui.perfetto.dev 에서 열기). traceWrite 는 traceStop() 뒤에.
+//
+//       TRACE_SCOPE("name");            // 이 블록이 끝날 때까지를 한 구간으로
+//       TRACE_COUNTER("name", value);   // 시각별 값 (테이블 크기 등)
+//       TRACE_PHASES(p); TRACE_NEXT(p, "a"); ... TRACE_NEXT(p, "b");
+//                                       // 이어지는 단계들 (앞 단계는 다음 단계가 시작될 때 끝남)
+//       이름은 문자열 상수만 (포인터를 그대로 저장함).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __traceH__
+#define __traceH__
+
+#ifdef USE_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TRACE_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+enum TraceKind {
+    TRACE_SPAN,
+    TRACE_VALUE,
+};
+
+struct TraceRecord {
+    uint64_t    start;   // tick
+    int64_t     value;   // span: 길이 (tick), 카운터: 값
+    const char* name;
+    int         kind;    // TraceKind
+};
+
+const int TRACE_CAPACITY = 1 << 15;   // 스레드당 기록 수 (1MB)
+
+struct TraceBuffer {
+    TraceRecord           records[TRACE_CAPACITY];
+    std::atomic<uint64_t> count;   // 지금까지 쓴 수 (ring 위치는 count % TRACE_CAPACITY)
+    int                   tid;
+    const char*           threadName;
+    TraceBuffer*          next;    // 등록된 스레드 목록
+};
+
+extern std::atomic<bool> g_traceOn;
+
+// TSC 가 있으면 TSC (몇 ns), 없으면 steady_clock (ns). 실제 시간으로는 traceWrite 에서 환산.
+inline uint64_t traceTicks()
+{
+#ifdef TRACE_TSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+TraceBuffer* traceRegisterThread();   // 이 스레드의 ring 을 만들어 목록에 넣음 (처음 한 번)
+
+inline TraceBuffer* traceThreadBuffer()
+{
+    static thread_local TraceBuffer* buffer = nullptr;
+    if (!buffer) buffer = traceRegisterThread();
+    return buffer;
+}
+
+inline void traceRecord(const char* name, uint64_t start, int64_t value, int kind)
+{
+    TraceBuffer* b = traceThreadBuffer();
+    uint64_t n = b->count.load(std::memory_order_relaxed);
+    TraceRecord& r = b->records[n & (TRACE_CAPACITY - 1)];
+    r.start = start;
+    r.value = value;
+    r.name = name;
+    r.kind = kind;
+    b->count.store(n + 1, std::memory_order_release);
+}
+
+class CTraceScope {
+public:
+    explicit CTraceScope(const char* name)
+        : m_name(name), m_start(g_traceOn.load(std::memory_order_relaxed) ? traceTicks() : 0) {}
+    ~CTraceScope()
+    {
+        if (m_start) traceRecord(m_name, m_start, (int64_t)(traceTicks() - m_start), TRACE_SPAN);
+    }
+
+private:
+    const char* m_name;
+    uint64_t    m_start;
+};
+
+// 한 함수 안에서 이어지는 단계들. 블록으로 나누지 않고 경계에서 next 만 부름.
+class CTracePhases {
+public:
+    CTracePhases() : m_name(NULL), m_start(0) {}
+    ~CTracePhases() { next(NULL); }
+
+    void next(const char* name)
+    {
+        uint64_t now = m_start || (name && g_traceOn.load(std::memory_order_relaxed)) ? traceTicks() : 0;
+        if (m_start) traceRecord(m_name, m_start, (int64_t)(now - m_start), TRACE_SPAN);
+        m_name = name;
+        m_start = name && g_traceOn.load(std::memory_order_relaxed) ? now : 0;
+    }
+
+private:
+    const char* m_name;
+    uint64_t    m_start;
+};
+
+void traceStart();
+void traceStop();
+void traceThreadName(const char* name);   // 이 스레드의 표시 이름 (문자열 상수)
+bool traceWrite(const char* path);        // Chrome trace JSON. 실패하면 false.
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(name) CTraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_PHASES(var) CTracePhases var
+#define TRACE_NEXT(var, name) (var).next(name)
+#define TRACE_COUNTER(name, value)                                                         \
+    do {                                                                                   \
+        if (g_traceOn.load(std::memory_order_relaxed))                                     \
+            traceRecord(name, traceTicks(), (int64_t)(value), TRACE_VALUE);                \
+    } while (0)
+
+#else // USE_TRACE
+
+inline void traceStart() {}
+inline void traceStop() {}
+inline void traceThreadName(const char*) {}
+inline bool traceWrite(const char*) { return false; }
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_PHASES(var) ((void)0)
+#define TRACE_NEXT(var, name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+
+#endif // USE_TRACE
+
+#endif // __traceH__
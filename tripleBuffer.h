@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// File: tripleBuffer.h
+//
+// Desc: 쓰는 스레드 하나, 읽는 스레드 하나용 lock-free triple buffer.
+//       쓰는 쪽은 back 에 채우고 publish(), 읽는 쪽은 update() 후 front 를 읽음.
+//       가운데 버퍼를 atomic 교환으로 주고받으므로 어느 쪽도 기다리지 않고,
+//       읽는 쪽은 항상 가장 최근에 완성된 값을 봄 (중간 값은 건너뛸 수 있음).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __tripleBufferH__
+#define __tripleBufferH__
+
+#include <atomic>
+
+template <typename T>
+class CTripleBuffer {
+public:
+    // m_middle: 하위 2 bit = 가운데 버퍼 번호, DIRTY = 아직 안 읽은 새 값
+    CTripleBuffer() : m_middle(1), m_back(2), m_front(0) {}
+
+    // 쓰는 스레드
+    T&   back() { return m_buf[m_back]; }
+    void publish()
+    {
+        unsigned old = m_middle.exchange(m_back | DIRTY, std::memory_order_acq_rel);
+        m_back = old & INDEX;
+    }
+
+    // 읽는 스레드. 새 값이 있었으면 true.
+    bool update()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & DIRTY)) return false;
+        unsigned old = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = old & INDEX;
+        return true;
+    }
+    const T& front() const { return m_buf[m_front]; }
+
+private:
+    enum { INDEX = 3, DIRTY = 4 };
+
+    T                     m_buf[3];
+    alignas(64) std::atomic<unsigned> m_middle;
+    alignas(64) unsigned  m_back;    // 쓰는 스레드만
+    alignas(64) unsigned  m_front;   // 읽는 스레드만
+};
+
+#endif // __tripleBufferH__
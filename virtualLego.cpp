@@ -11,11 +11,19 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "d3dUtility.h"
+#include "qTable.h"
+#include "policyTable.h"
+#include "neuralPolicy.h"
+#include "simThread.h"
+#include "framePacer.h"
+#include "trace.h"
+#include "allocTrack.h"
 #include <vector>
 #include <ctime>
 #include <cstdlib>
 #include <cstdio>
 #include <cassert>
+#include <cstring>
 
 // 디버깅 시 해제해 주세요
 // #include <iostream>
@@ -38,10 +46,12 @@ const char* casino_image = "casino_image.png";
 const char* space_image = "space_image.jpg";
 
 
-const float TABLE_X_MIN = -4.56f + 0.12f;
-const float TABLE_X_MAX = 4.56f - 0.12f;
-const float TABLE_Z_MIN = -3.06f + 0.12f;
-const float TABLE_Z_MAX = 3.06f - 0.12f;
+// 테이블 규격 (tableSpec.h). 조준선은 공 중심이 쿠션에 닿아 꺾이는 곳 (물리의 위치 보정과 같은 범위).
+const TableSpec& TABLE = CAROM_TABLE;
+const float TABLE_X_MIN = (float)-TABLE.xMax();
+const float TABLE_X_MAX = (float)TABLE.xMax();
+const float TABLE_Z_MIN = (float)-TABLE.zMax();
+const float TABLE_Z_MAX = (float)TABLE.zMax();
 const float TABLE_Y = -0.00012f;
 
 struct LineVertex {
@@ -54,25 +64,24 @@ struct LineVertex {
 const int Width = 1024;
 const int Height = 768;
 
-// forward declaration for CSphere
-class CSphere;
-
-// Global Variable By Us
-bool isTurnStarted = false;
-int isWhiteTurn = 1; // 하얀공부터 시작하는 걸로
-int whiteScore = 0;
-int yellowScore = 0;
-int winScore = 1;
-int winner = 0;
-
-bool isInitBlue = false;
-
-CSphere* gs; // 포인터 선언만 가능 -> 이후에 g_sphere 배열 가리킬 예정.
-CSphere* blue; // 선언 문제 -> g_sphere_blueball 가리킬 예정
-
-// There are four balls
-// initialize the position (coordinate) of each ball (ball0 ~ ball3)
-const float spherePos[4][2] = { {-2.7f,0} , {+2.4f,0} , {3.3f, 0} , {-2.7f,-0.9f} };
+// 게임 한 판의 상태 (공 위치/속도, 턴, 점수, 노란공 AI) 는 모두 여기. 화면은 그리기만 함.
+CGameSession g_session;
+// 물리/점수/AI 는 이 스레드에서. 화면은 g_simThread.latest() 만 읽고 입력은 post() 로 보냄.
+CSimThread g_simThread(g_session);
+// "-3c": 시뮬레이션 스레드의 이벤트를 화면 쪽에서 꺼내 3 쿠션 판정도 같이 표시
+CEventBus g_events;
+CThreeCushionJudge g_threeCushion;
+bool g_showThreeCushion = false;
+// 바뀐 것이 있을 때만 그림. 공이 움직이는 동안은 60fps, 멈춰 있으면 입력이 올 때까지 잠듦.
+CFramePacer g_pacer(60.0);
+// 시뮬레이션 스레드가 바뀐 상태를 내보낼 때 신호 (자동 리셋). 잠든 메시지 루프를 깨움.
+HANDLE g_simWake = NULL;
+const double INPUT_WAKE_MS = 50;   // 입력을 보낸 뒤 시뮬레이션 스레드가 적용할 때까지 깨어 있는 시간
+// "-trace": 실행 동안의 구간을 끝날 때 이 파일로 (USE_TRACE 빌드만, chrome://tracing 에서 열기)
+const char* TRACE_FILE = "trace.json";
+bool g_trace = false;
+
+// There are four balls (위치는 g_session.world(), billiardSim 의 SIM_START_POS 에서 시작)
 // initialize the color of each ball (ball0 ~ ball3)
 const D3DXCOLOR sphereColor[4] = { d3d::RED, d3d::RED, d3d::YELLOW, d3d::WHITE };
 
@@ -83,22 +92,18 @@ D3DXMATRIX g_mWorld;
 D3DXMATRIX g_mView;
 D3DXMATRIX g_mProj;
 
-#define M_RADIUS 0.21   // ball radius
+const double M_RADIUS = TABLE.radius;   // ball radius
 #define PI 3.14159265
 #define M_HEIGHT 0.01
-#define DECREASE_RATE 0.9982
 
 // -----------------------------------------------------------------------------
 // CSphere class definition
 // -----------------------------------------------------------------------------
 
-class CSphere {   // CSphere 클래스
+class CSphere {   // CSphere 클래스 (그리기 전용, 물리는 g_session)
 private:
     float					center_x, center_y, center_z;
     float                   m_radius;
-    float					m_velocity_x;
-    float					m_velocity_z;
-    bool                    hit[4];
 
 public:
 
@@ -107,8 +112,6 @@ public:
         D3DXMatrixIdentity(&m_mLocal);
         ZeroMemory(&m_mtrl, sizeof(m_mtrl));
         m_radius = 0;
-        m_velocity_x = 0;
-        m_velocity_z = 0;
         m_pSphereMesh = NULL;
     }
     ~CSphere(void) {}
@@ -148,139 +151,6 @@ public:
         m_pSphereMesh->DrawSubset(0);
     }
 
-    bool hasIntersected(CSphere& ball)
-    {
-        D3DXVECTOR3 c1 = this->getCenter();
-        D3DXVECTOR3 c2 = ball.getCenter();
-
-        float dx = c1.x - c2.x;
-        float dz = c1.z - c2.z;
-
-        float distance = sqrt(dx * dx + dz * dz);
-        float radiusSum = this->getRadius() + ball.getRadius();
-
-
-
-        // 충돌 시 변수 업데이트
-        // 상대 ball 도 바꿔야 함.
-        if (distance <= radiusSum) {
-            if (this == &(gs[0])) {
-                ball.hit[0] = true;
-            }
-            else if (this == &(gs[1])) {
-                ball.hit[1] = true;
-            }
-            else if (this == &(gs[2])) {
-                ball.hit[2] = true;
-            }
-            else if (this == &(gs[3])) {
-                ball.hit[3] = true;
-            }
-
-            if (&ball == &(gs[0])) {
-                this->hit[0] = true; //Red1
-            }
-            else if (&ball == &(gs[1])) {
-                this->hit[1] = true; //Red2
-            }
-            else if (&ball == &(gs[2])) {
-                this->hit[2] = true; //Yellow
-            }
-            else if (&ball == &(gs[3])) {
-                this->hit[3] = true; //White
-            }
-        }
-
-        return distance <= radiusSum;
-    }
-
-    void hitBy(CSphere& ball)
-    {
-        if (!hasIntersected(ball)) return;
-
-        // 중심 벡터 및 거리
-        D3DXVECTOR3 c1 = this->getCenter();
-        D3DXVECTOR3 c2 = ball.getCenter();
-        D3DXVECTOR3 n = c1 - c2;  // 충돌 방향
-        D3DXVec3Normalize(&n, &n);
-
-        // 상대 속도
-        D3DXVECTOR3 v1(this->getVelocity_X(), 0, this->getVelocity_Z());
-        D3DXVECTOR3 v2(ball.getVelocity_X(), 0, ball.getVelocity_Z());
-        D3DXVECTOR3 relVel = v1 - v2;
-
-        // 두 공이 서로 멀어지는 중이면 무시
-        if (D3DXVec3Dot(&relVel, &n) > 0)
-            return;
-
-        // 반사계수 e = 1 (완전탄성)
-        float e = 1.0f;
-
-        // 질량이 같을 때 단순화된 속도 교환 공식
-        float v1n = D3DXVec3Dot(&v1, &n);
-        float v2n = D3DXVec3Dot(&v2, &n);
-
-        float p = (v1n - v2n);
-
-        v1 -= n * p;
-        v2 += n * p;
-
-        this->setPower(v1.x, v1.z);
-        ball.setPower(v2.x, v2.z);
-
-        // --- 살짝 겹쳐진 공 위치 보정 (안 겹치게 밀기) ---
-        float dist = D3DXVec3Length(&(c1 - c2));
-        float overlap = (this->getRadius() + ball.getRadius() - dist) * 0.5f;
-        if (overlap > 0)
-        {
-            D3DXVECTOR3 correction = n * overlap;
-            this->setCenter(c1.x + correction.x, c1.y, c1.z + correction.z);
-            ball.setCenter(c2.x - correction.x, c2.y, c2.z - correction.z);
-        }
-    }
-
-    void ballUpdate(float timeDiff)
-    {
-        const float TIME_SCALE = 3.3;
-        D3DXVECTOR3 cord = this->getCenter();
-        double vx = abs(this->getVelocity_X());
-        double vz = abs(this->getVelocity_Z());
-
-        if (vx > 0.01 || vz > 0.01)
-        {
-            float tX = cord.x + TIME_SCALE * timeDiff * m_velocity_x;
-            float tZ = cord.z + TIME_SCALE * timeDiff * m_velocity_z;
-
-            //correction of position of ball
-            // Please uncomment this part because this correction of ball position is necessary when a ball collides with a wall
-            if (tX >= (4.5 - M_RADIUS))
-                tX = 4.5 - M_RADIUS;
-            else if (tX <= (-4.5 + M_RADIUS))
-                tX = -4.5 + M_RADIUS;
-            else if (tZ <= (-3 + M_RADIUS))
-                tZ = -3 + M_RADIUS;
-            else if (tZ >= (3 - M_RADIUS))
-                tZ = 3 - M_RADIUS;
-
-            this->setCenter(tX, cord.y, tZ);
-        }
-        else { this->setPower(0, 0); }
-        //this->setPower(this->getVelocity_X() * DECREASE_RATE, this->getVelocity_Z() * DECREASE_RATE);
-        double rate = 1 - (1 - DECREASE_RATE) * timeDiff * 400;
-        if (rate < 0)
-            rate = 0;
-        this->setPower(getVelocity_X() * rate, getVelocity_Z() * rate);
-    }
-
-    double getVelocity_X() { return this->m_velocity_x; }
-    double getVelocity_Z() { return this->m_velocity_z; }
-
-    void setPower(double vx, double vz)
-    {
-        this->m_velocity_x = vx;
-        this->m_velocity_z = vz;
-    }
-
     void setCenter(float x, float y, float z)
     {
         D3DXMATRIX m;
@@ -298,72 +168,6 @@ public:
         return org;
     }
 
-    /*
-    공별로 점수를 계산하는 함수. 실행 시에는 흰 공(player 1)과 노란 공(player 2)만을 대상으로 고려하면 됨.
-    Rule: 흰 공, 또는 노란 공이 1. 상대방의 공을 건드렸거나, 빨간 공을 하나도 못 쳤을 경우 -1점 2. NOT 1이면서 빨간 공을 한개만 친 경우 0점. 3. NOT 1이면서 빨간 공을 두개 모두 친 경우 +1점.
-    total_score>0일 시 턴 유지, 그렇지 않은 경우 턴 토글.
-    ball number 0: r, 1: r, 2: y, 3: w
-    */
-    int getScore() {
-
-        int total_score = 0;
-
-        switch (isWhiteTurn) {
-            // player 1's turn
-        case (1):
-            // case 1
-            if (this->hit[2] == true) {
-                total_score = -1;
-            }
-            else if (this->hit[0] == false && this->hit[1] == false) {
-                total_score = -1;
-            }
-            // case 2
-            else if ((this->hit[0] == true && this->hit[1] == false) || (this->hit[1] == true && this->hit[0] == false)) {
-                total_score = 0;
-            }
-            // case 3
-            else if ((this->hit[0] && this->hit[1]) == true) {
-                total_score = 1;
-            }
-            break;
-
-            // player 2's turn
-        case (-1):
-            // case 1
-            if (this->hit[3] == true) {
-                total_score = -1;
-            }
-            else if (this->hit[0] == false && this->hit[1] == false) {
-                total_score = -1;
-            }
-            // case 2
-            else if ((this->hit[0] == true && this->hit[1] == false) || (this->hit[1] == true && this->hit[0] == false)) {
-                total_score = 0;
-            }
-            // case 3
-            else if ((this->hit[0] && this->hit[1]) == true) {
-                total_score = 1;
-            }
-            break;
-
-            // unexpected value for isWhiteTurn.
-        default:
-            break;
-        }
-
-        return total_score;
-    }
-    void hit_initialize() {
-        for (int i = 0; i < 4; i++) {
-            hit[i] = false;
-        }
-    }
-
-    bool* getHit() {
-        return hit;
-    }
-
 private:
     D3DXMATRIX              m_mLocal;
     D3DMATERIAL9            m_mtrl;
@@ -371,8 +175,6 @@ private:
 
 };
 
-
-
 // -----------------------------------------------------------------------------
 // CWall class definition
 // -----------------------------------------------------------------------------
@@ -433,50 +235,6 @@ public:
         m_pBoundMesh->DrawSubset(0);
     }
 
-    bool hasIntersected(CSphere& ball)
-    {
-        D3DXVECTOR3 center = ball.getCenter();
-        float r = ball.getRadius();
-
-        // 예시: 위쪽 벽 (z가 +3 근처)
-        if (fabs(m_z) > 0 && m_z > 0) { // 위쪽 벽이라면
-            if (center.z + r >= m_z - (m_depth / 2))
-                return true;
-        }
-        // 아래쪽 벽
-        else if (fabs(m_z) > 0 && m_z < 0) {
-            if (center.z - r <= m_z + (m_depth / 2))
-                return true;
-        }
-        // 오른쪽 벽
-        else if (fabs(m_x) > 0 && m_x > 0) {
-            if (center.x + r >= m_x - (m_width / 2))
-                return true;
-        }
-        // 왼쪽 벽
-        else if (fabs(m_x) > 0 && m_x < 0) {
-            if (center.x - r <= m_x + (m_width / 2))
-                return true;
-        }
-
-        return false;
-    }
-
-    void hitBy(CSphere& ball)
-    {
-        if (!hasIntersected(ball)) return;
-
-        // 공의 현재 속도
-        double vx = ball.getVelocity_X();
-        double vz = ball.getVelocity_Z();
-
-        // 벽이 어느 방향에 있는가에 따라 반사
-        if (fabs(m_z) > 0)  // 위/아래 벽
-            ball.setPower(vx, -vz);
-        else if (fabs(m_x) > 0) // 좌/우 벽
-            ball.setPower(-vx, vz);
-    }
-
     void setPosition(float x, float y, float z)
     {
         D3DXMATRIX m;
@@ -589,186 +347,19 @@ private:
 // Algorithms
 // -----------------------------------------------------------------------------
 
-// 상대 좌표 기반 상태
-struct State {
-    int dx1, dz1; // red1 - yellow 상대 위치
-    int dx2, dz2; // red2 - yellow 상대 위치
-    int dxw, dzw; // white - yellow 상대 위치
-    int tx, tz; // 파란공 - yellow 상대 위치
-};
-
-// Q-learning 용 엔트리
-struct QEntry {
-    State state;        // 상태
-    float totalReward;  // 누적 보상
-    int count;          // 시도 횟수
-    float avgReward;    // 평균 보상
-};
-
-// global variables for algorithms
-std::vector<QEntry> QTable;
-State lastState;
-
-// functions of algorithms
-int bin(float v, float step = 0.5f) {
-    // 0.5 단위로 좌표를 정수화
-    return int(v / step);
-}
-
-State getCurrentState() {   // 현재 상태 계산 함수
-    D3DXVECTOR3 red1 = gs[0].getCenter();
-    D3DXVECTOR3 red2 = gs[1].getCenter();
-    D3DXVECTOR3 white = gs[3].getCenter();
-    D3DXVECTOR3 yellow = gs[2].getCenter();
-    D3DXVECTOR3 target = blue->getCenter();
-
-    State s;
-    s.dx1 = bin(red1.x - yellow.x);
-    s.dz1 = bin(red1.z - yellow.z);
-    s.dx2 = bin(red2.x - yellow.x);
-    s.dz2 = bin(red2.z - yellow.z);
-    s.dxw = bin(white.x - yellow.x);
-    s.dzw = bin(white.z - yellow.z);
-    s.tx = bin(target.x - yellow.x);
-    s.tz = bin(target.z - yellow.z);
-    return s;
-}
-
-void UpdateQTable(std::vector<QEntry>& qTable, const State& s, float reward) {   // QTable 갱신 함수
-    for (auto& e : qTable) {
-        if (memcmp(&e.state, &s, sizeof(State)) == 0) {
-            // 기존 state 발견 → 업데이트
-            e.totalReward += reward;
-            e.count++;
-            e.avgReward = e.totalReward / e.count;
-            return;
-        }
-    }
-
-    // 새로운 state 추가
-    QEntry entry;
-    entry.state = s;
-    entry.totalReward = reward;
-    entry.count = 1;
-    entry.avgReward = reward;
-    qTable.push_back(entry);
-}
-
-// Parameter File Load/Save
-void SaveQTable(const std::vector<QEntry>& qTable) {
-    FILE* fp = fopen("ai_qtable.txt", "w");
-    if (!fp) return;
-    for (auto& e : qTable) {
-        fprintf(fp, "%d %d %d %d %d %d %d %d %f %d %f\n",
-            e.state.dx1, e.state.dz1,
-            e.state.dx2, e.state.dz2,
-            e.state.dxw, e.state.dzw,
-            e.state.tx, e.state.tz,
-            e.totalReward, e.count, e.avgReward);
-    }
-    fclose(fp);
-}
-
-void LoadQTable(std::vector<QEntry>& qTable) {
-    qTable.clear();
-    FILE* fp = fopen("ai_qtable.txt", "r");
-    if (!fp) return;
-
-    QEntry e;
-    while (fscanf(fp, "%d %d %d %d %d %d %d %d %f %d %f",
-        &e.state.dx1, &e.state.dz1,
-        &e.state.dx2, &e.state.dz2,
-        &e.state.dxw, &e.state.dzw,
-        &e.state.tx, &e.state.tz,
-        &e.totalReward, &e.count, &e.avgReward) == 11)
-    {
-        qTable.push_back(e);
-    }
-    fclose(fp);
-}
-
-// ai 발사 로직
-void AIFireYellowBall(std::vector<QEntry>& qTable) {
-    // 현재 게임판 상태
-    State baseState = getCurrentState();
-
-    float tx = 0, tz = 0;
-
-    // 1️⃣ 학습된 상태 중 평균보상이 가장 높은 조준을 찾기
-    auto best = std::max_element(qTable.begin(), qTable.end(),
-        [&](const QEntry& a, const QEntry& b) {
-            // 현재 환경이 유사한 상태만 비교
-            bool similarA = (abs(a.state.dx1 - baseState.dx1) <= 1 &&
-                abs(a.state.dx2 - baseState.dx2) <= 1);
-            bool similarB = (abs(b.state.dx1 - baseState.dx1) <= 1 &&
-                abs(b.state.dx2 - baseState.dx2) <= 1);
-            if (!similarA && !similarB) return false;
-            if (similarA && !similarB) return false;
-            if (!similarA && similarB) return true;
-            return a.avgReward < b.avgReward;
-        });
-
-    // 2️⃣ 80% 확률로 best, 20% 확률로 탐색(random)
-    if (best != qTable.end() && (rand() % 100) < 80) {
-        tx = best->state.tx * 0.5f;  // 다시 실제좌표로 환산
-        tz = best->state.tz * 0.5f;
-    }
-    else {
-        tx = ((rand() % 1200) / 100.0f - 6.0f);
-        tz = ((rand() % 800) / 100.0f - 4.0f);
-    }
-
-    // 파란공 조준점 이동
-    blue->setCenter(tx, (float)M_RADIUS, tz);
-
-    // 노란공 발사
-    D3DXVECTOR3 target = blue->getCenter();
-    D3DXVECTOR3 yellow = gs[2].getCenter();
-    double theta = atan2(target.z - yellow.z, target.x - yellow.x);
-    double dist = sqrt(pow(target.x - yellow.x, 2) + pow(target.z - yellow.z, 2));
-    gs[2].setPower(dist * cos(theta), dist * sin(theta));
-
-    // 현재 상태 저장 (턴 종료 후 보상 업데이트용)
-    lastState = baseState;
-    lastState.tx = bin(tx - yellow.x);
-    lastState.tz = bin(tz - yellow.z);
-}
-
-int calculateAIPoint(CSphere& yellowBall) // 보상 점수 계산
-{
-    bool* h = yellowBall.getHit();  // hit 배열 포인터 반환 (또는 직접 접근 가능)
-    int score = 0;
-
-    // 1️⃣ 흰공과 부딪혔으면 무조건 -1점 (파울)
-    if (h[3]) {
-        score = -1;
-    }
-    // 2️⃣ 두 빨간공 모두 명중
-    else if (h[0] && h[1] && !h[2] && !h[3]) {
-        score = +2;
-    }
-    // 3️⃣ 빨간공 중 하나만 명중
-    else if ((h[0] ^ h[1]) && !h[2] && !h[3]) {
-        score = +1;
-    }
-    // 4️⃣ 아무것도 맞추지 못함
-    else if (!h[0] && !h[1] && !h[2] && !h[3]) {
-        score = -1;
-    }
+// 여러 세션이 같이 읽기만 하는 AI 정책들 (g_session.ai() 가 가리킴)
+// "-nolearn" 로 실행하면 학습(갱신/저장) 없이 컴파일된 정책표 (qTableTool compile) 로만 둠
+CPolicyTable g_policy;
 
-    return score;
-}
-
-
-void OnAITurnEnd() {
-    int reward = calculateAIPoint(gs[2]);
-    UpdateQTable(QTable, lastState, (float)reward);
-    SaveQTable(QTable);
+// "-mlp" 로 실행하면 조준을 MLP 정책 (qTableTool train-mlp) 으로 고름
+CNeuralPolicy g_mlp;
 
-    // 다음 턴 준비: hit 초기화
-    bool* hit = gs[2].getHit();
-    for (int i = 0; i < 4; i++) hit[i] = false;
-}
+// "-plan [ms]" 로 실행하면 시뮬레이터로 여러 턴을 내다보고 조준 (다른 정책보다 우선)
+// g_pool 은 AI 조준/저장 작업도 돌림 (시뮬레이션 스레드가 기다리지 않도록)
+CThreadPool* g_pool = NULL;
+CShotPlanner* g_planner = NULL;
+// "-aim [ms]" 은 이번 샷만 조준 최적화 (-plan 이 없을 때)
+CAimOptimizer* g_aim = NULL;
 
 
 // -----------------------------------------------------------------------------
@@ -801,24 +392,26 @@ bool Setup()
     D3DXMatrixIdentity(&g_mProj);
 
     // create plane and set the position : 바닥 생성, 위치 세팅
-    if (false == g_legoPlane.create(Device, -1, -1, 9, 0.03f, 6, d3d::GREEN)) return false;
+    const float planeX = (float)(2 * TABLE.halfX), planeZ = (float)(2 * TABLE.halfZ);
+    const float cushion = (float)TABLE.cushion;
+    if (false == g_legoPlane.create(Device, -1, -1, planeX, 0.03f, planeZ, d3d::GREEN)) return false;
     g_legoPlane.setPosition(0.0f, -0.0006f / 5, 0.0f);
 
     // create walls and set the position. note that there are four walls : 벽(4개) 생성,
-    if (false == g_legowall[0].create(Device, -1, -1, 9, 0.3f, 0.12f, d3d::DARKRED)) return false;
-    g_legowall[0].setPosition(0.0f, 0.12f, 3.06f);
-    if (false == g_legowall[1].create(Device, -1, -1, 9, 0.3f, 0.12f, d3d::DARKRED)) return false;
-    g_legowall[1].setPosition(0.0f, 0.12f, -3.06f);
-    if (false == g_legowall[2].create(Device, -1, -1, 0.12f, 0.3f, 6.24f, d3d::DARKRED)) return false;
-    g_legowall[2].setPosition(4.56f, 0.12f, 0.0f);
-    if (false == g_legowall[3].create(Device, -1, -1, 0.12f, 0.3f, 6.24f, d3d::DARKRED)) return false;
-    g_legowall[3].setPosition(-4.56f, 0.12f, 0.0f);
+    // 벽 중심은 쿠션 안쪽 면에서 두께 절반 바깥 (4구 테이블: z = ±3.06, x = ±4.56)
+    if (false == g_legowall[0].create(Device, -1, -1, planeX, 0.3f, cushion, d3d::DARKRED)) return false;
+    g_legowall[0].setPosition(0.0f, 0.12f, (float)TABLE.wallZ());
+    if (false == g_legowall[1].create(Device, -1, -1, planeX, 0.3f, cushion, d3d::DARKRED)) return false;
+    g_legowall[1].setPosition(0.0f, 0.12f, (float)-TABLE.wallZ());
+    if (false == g_legowall[2].create(Device, -1, -1, cushion, 0.3f, planeZ + 2 * cushion, d3d::DARKRED)) return false;
+    g_legowall[2].setPosition((float)TABLE.wallX(), 0.12f, 0.0f);
+    if (false == g_legowall[3].create(Device, -1, -1, cushion, 0.3f, planeZ + 2 * cushion, d3d::DARKRED)) return false;
+    g_legowall[3].setPosition((float)-TABLE.wallX(), 0.12f, 0.0f);
 
     // create four balls and set the position : 공(4개 생성)
     for (i = 0; i < 4; i++) {
         if (false == g_sphere[i].create(Device, sphereColor[i])) return false;
-        g_sphere[i].setCenter(spherePos[i][0], (float)M_RADIUS, spherePos[i][1]);
-        g_sphere[i].setPower(0, 0);
+        g_sphere[i].setCenter(SIM_START_POS[i][0], (float)M_RADIUS, SIM_START_POS[i][1]);
     }
 
     // create blue ball for set direction
@@ -912,9 +505,12 @@ bool Setup()
 
     // 배경 설정 시작
     // 배경 텍스처 로드
-    if (FAILED(D3DXCreateTextureFromFile(Device, space_image, &g_pBackgroundTex))) {
-        MessageBox(0, "Failed to load background texture!", 0, 0);
-        return false;
+    {
+        TRACE_SCOPE("load texture");
+        if (FAILED(D3DXCreateTextureFromFile(Device, space_image, &g_pBackgroundTex))) {
+            MessageBox(0, "Failed to load background texture!", 0, 0);
+            return false;
+        }
     }
 
     // Set render states.
@@ -928,6 +524,8 @@ bool Setup()
 
 void Cleanup(void)
 {
+    g_simThread.stop();   // 이후로는 세션을 이 스레드에서 만져도 됨
+    g_session.waitBackground();   // 돌고 있던 AI 조준/저장이 정책/풀을 쓰고 있을 수 있음
     g_legoPlane.destroy();
     for (int i = 0; i < 4; i++) {
         g_legowall[i].destroy();
@@ -942,66 +540,43 @@ void Cleanup(void)
     }
     destroyAllLegoBlock();
     g_light.destroy();
-
-    SaveQTable(QTable);
+    g_policy.close();
+    g_session.ai().planner = NULL;
+    g_session.ai().aim = NULL;
+    g_session.ai().executor = NULL;
+    delete g_planner;
+    g_planner = NULL;
+    delete g_aim;
+    g_aim = NULL;
+    delete g_pool;
+    g_pool = NULL;
+
+    if (g_session.ai().learning) g_session.saveLearning();
 
 }
 
-void updateScore(CSphere& ball) {
-    int score = ball.getScore();
-
-    switch (isWhiteTurn) {
-        // 하얀공 턴
-    case (1):
-        if (score == 1) {
-            whiteScore += 1;
-        }
-        else if (score == -1) {
-            whiteScore += -1;
-            isWhiteTurn = -isWhiteTurn; // turn change
-        }
-        else if (score == 0) {
-            isWhiteTurn = -isWhiteTurn; // turn change
-        }
-        break;
-        // 노란공 턴
-    case (-1):
-        if (score == 1) {
-            yellowScore += 1;
-        }
-        else if (score == -1) {
-            yellowScore += -1;
-            isWhiteTurn = -isWhiteTurn; // turn change
-        }
-        else if (score == 0) {
-            isWhiteTurn = -isWhiteTurn; // turn change
-        }
-        break;
-    default:
-        break;
-    }
-
-    for (int i = 0; i < 4; i++) {
-        g_sphere[i].hit_initialize();
-    }
-
-    if (isWhiteTurn == -1) { // 노란공일떄 학습 업데이트
-        OnAITurnEnd();
+// 마지막으로 그린 상태와 비교해서 다시 그려야 할 부분
+static unsigned frameChanges(const GameSnapshot& drawn, const GameSnapshot& snap)
+{
+    unsigned flags = 0;
+    for (int i = 0; i < SIM_BALLS; i++) {
+        if (drawn.ball[i].x != snap.ball[i].x || drawn.ball[i].z != snap.ball[i].z) flags |= FRAME_MOTION;
     }
+    if (drawn.targetX != snap.targetX || drawn.targetZ != snap.targetZ) flags |= FRAME_AIM;
+    if (drawn.turnCount != snap.turnCount) flags |= FRAME_AIM;   // 조준선 다시 표시
+    if (drawn.isWhiteTurn != snap.isWhiteTurn || drawn.isThinking != snap.isThinking ||
+        drawn.whiteScore != snap.whiteScore || drawn.yellowScore != snap.yellowScore ||
+        drawn.winner != snap.winner) flags |= FRAME_SCORE;
+    return flags;
+}
 
-    // 승리 판별하기.
-    if (whiteScore >= winScore) {
-        winner = 3;
-    }
-    else if (yellowScore >= winScore) {
-        winner = 2;
-    }
-    // 판별해서 이긴쪽. 폰트 생성? -> display() 마다 보이도록
-    isInitBlue = false;
+static void wakeDisplay(void*)
+{
+    ::SetEvent(g_simWake);
 }
 
 // timeDelta represents the time between the current image frame and the last image frame.
-// the distance of moving balls should be "velocity * timeDelta"
+// 공 이동은 g_simThread 가 고정 간격으로 하므로 여기서는 그리기만 함 (timeDelta 는 안 씀)
 bool Display(float timeDelta)   // 매 프레임 실행
 {
     int i = 0;
@@ -1010,6 +585,19 @@ bool Display(float timeDelta)   // 매 프레임 실행
 
     if (Device)
     {
+        TRACE_SCOPE("Display");
+        ALLOC_FORBID("frame");
+        TRACE_PHASES(phase);
+        TRACE_NEXT(phase, "snapshot");
+        // 시뮬레이션 스레드가 마지막으로 내보낸 상태. 그린 것과 같으면 그리지 않음.
+        static GameSnapshot drawn;
+        const GameSnapshot& snap = g_simThread.latest();
+        if (g_showThreeCushion) g_events.dispatch();   // 턴 끝 이벤트는 그 턴의 snapshot 보다 먼저 들어옴
+        g_pacer.markDirty(frameChanges(drawn, snap));
+        if (!(g_pacer.dirty() & ~FRAME_SNAPSHOT)) return true;   // 깨운 상태를 이미 그렸음
+        drawn = snap;
+
+        TRACE_NEXT(phase, "background");
         Device->Clear(0, 0, D3DCLEAR_TARGET | D3DCLEAR_ZBUFFER, 0x00afafaf, 1.0f, 0);
         Device->BeginScene();
 
@@ -1051,45 +639,17 @@ bool Display(float timeDelta)   // 매 프레임 실행
         Device->SetTransform(D3DTS_VIEW, &oldView);
         Device->SetTransform(D3DTS_PROJECTION, &oldProj);
 
-        // update the position of each ball. during update, check whether each ball hit by walls.
-        for (i = 0; i < 4; i++) {
-            g_sphere[i].ballUpdate(timeDelta);
-            for (j = 0; j < 4; j++) { g_legowall[i].hitBy(g_sphere[j]); }
-        }
-
-        // check whether any two balls hit together and update the direction of balls
-        for (i = 0; i < 4; i++) {
-            for (j = 0; j < 4; j++) {
-                if (i >= j) { continue; }
-                g_sphere[i].hitBy(g_sphere[j]);
-            }
-        }
-
-        // white Turn 일 때 파란공 위치 초기화
-        if ((isWhiteTurn == 1) && !isTurnStarted && !isInitBlue) { // 하얀색 공 턴이고 && 턴이 아직 시작 안된 상태고, isInitBlue가 false 일때 (그니까 매 프레임마다 가운데 위치로 셋되면 절대 안되니까, isInitBlue가 false일때만 하는걸로 하고, 턴 중에는 true 유지, 이후에 updateScore()에서 false 로 변함)
-            g_target_blueball.setCenter(.0f, (float)M_RADIUS, .0f);
-            isInitBlue = true;
+        // 시뮬레이션 스레드가 마지막으로 내보낸 상태를 그대로 그림
+        TRACE_NEXT(phase, "scene");
+        static int lastTurnCount = 0;
+        if (snap.turnCount != lastTurnCount) {
+            lastTurnCount = snap.turnCount;
+            showGuideLine = true;  // 모든 공이 멈추면 조준선 다시 표시
         }
-
-        // 모든 공이 거의 멈췄는지 체크
-        bool allStopped = true;
         for (i = 0; i < 4; i++) {
-            if (fabs(g_sphere[i].getVelocity_X()) > 0.03 ||
-                fabs(g_sphere[i].getVelocity_Z()) > 0.03) {
-                allStopped = false;
-                break;
-            }
-        }
-
-        // 모든 공이 멈췄으면 점수 계산
-        if (allStopped && isTurnStarted) { // isTurnStarted
-            if (isWhiteTurn == 1)
-                updateScore(g_sphere[3]);  // white
-            else
-                updateScore(g_sphere[2]);  // yellow
-            isTurnStarted = false; // 한 번만 계산되게
-            showGuideLine = true;  // 모든 공이 멈추면 조준선 다시 표시
+            g_sphere[i].setCenter(snap.ball[i].x, (float)M_RADIUS, snap.ball[i].z);
         }
+        g_target_blueball.setCenter(snap.targetX, (float)M_RADIUS, snap.targetZ);
 
         // draw plane, walls, and spheres
         g_legoPlane.draw(Device, g_mWorld);
@@ -1111,7 +671,8 @@ bool Display(float timeDelta)   // 매 프레임 실행
 
 
         // 조준선 (showGuideLine이 true일 때, white공 턴일때만 표시)
-        if (showGuideLine && isWhiteTurn == 1)
+        TRACE_NEXT(phase, "guide line");
+        if (showGuideLine && snap.isWhiteTurn == 1)
         {
             D3DXVECTOR3 cueBallPos = g_sphere[3].getCenter();
             D3DXVECTOR3 blueBallPos = g_target_blueball.getCenter();
@@ -1235,6 +796,7 @@ bool Display(float timeDelta)   // 매 프레임 실행
 
 
         // 점수판 및 턴 표시
+        TRACE_NEXT(phase, "text");
         if (g_pFont) {
             RECT rectWhite, rectYellow, rectTurn;
 
@@ -1245,14 +807,14 @@ bool Display(float timeDelta)   // 매 프레임 실행
 
             // 점수 문자열
             char whiteText[64], yellowText[64], turnText[64];
-            sprintf_s(whiteText, "WHITE: %d", whiteScore);
-            sprintf_s(yellowText, "YELLOW: %d", yellowScore);
+            sprintf_s(whiteText, "WHITE: %d", snap.whiteScore);
+            sprintf_s(yellowText, "YELLOW: %d", snap.yellowScore);
 
             // 턴 표시 문자열
-            if (isWhiteTurn == 1)
+            if (snap.isWhiteTurn == 1)
                 sprintf_s(turnText, "WHITE TURN !");
             else
-                sprintf_s(turnText, "YELLOW TURN ! \n  (Press Space)");
+                sprintf_s(turnText, snap.isThinking ? "YELLOW TURN ! \n  (Thinking...)" : "YELLOW TURN ! \n  (Press Space)");
 
             // 그림자용 사각형 (글자 대비용)
             RECT shadowWhite = rectWhite;
@@ -1272,14 +834,23 @@ bool Display(float timeDelta)   // 매 프레임 실행
             g_pFont->DrawTextA(NULL, yellowText, -1, &rectYellow, DT_NOCLIP, D3DXCOLOR(1.0f, 0.9f, 0.3f, 1.0f)); // 금빛 노란색 (YELLOW 팀)
 
             // 턴 표시 색상: 현재 턴에 따라 다르게 강조
-            if (isWhiteTurn == 1)
+            if (snap.isWhiteTurn == 1)
                 g_pFont->DrawTextA(NULL, turnText, -1, &rectTurn, DT_NOCLIP, D3DXCOLOR(0.5f, 0.8f, 1.0f, 1.0f)); // 하늘색 계열
             else
                 g_pFont->DrawTextA(NULL, turnText, -1, &rectTurn, DT_NOCLIP, D3DXCOLOR(1.0f, 0.8f, 0.3f, 1.0f)); // 노란빛
+
+            if (g_showThreeCushion) {
+                RECT rect3c;
+                SetRect(&rect3c, Width / 2 - 150, 10, 0, 0);
+                char text3c[64];
+                sprintf_s(text3c, "3-CUSHION  WHITE %d : %d YELLOW", g_threeCushion.points(1), g_threeCushion.points(-1));
+                g_pFont->DrawTextA(NULL, text3c, -1, &rect3c, DT_NOCLIP, D3DXCOLOR(1, 1, 1, 0.8f));
+            }
         }
 
 
         // 게임 종료 및 승자 표시
+        int winner = snap.winner;
         if (winner != 0) {
             if (winner == 2) {
                 if (win_Font) {
@@ -1303,6 +874,7 @@ bool Display(float timeDelta)   // 매 프레임 실행
 
 
 
+        TRACE_NEXT(phase, "present");
         Device->EndScene();
         Device->Present(0, 0, 0, 0);
         Device->SetTexture(0, NULL);
@@ -1327,6 +899,11 @@ LRESULT CALLBACK d3d::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
         ::PostQuitMessage(0);
         break;
     }
+    case WM_PAINT:   // 가려졌던 창이 다시 보일 때 (DefWindowProc 이 무효 영역을 정리함)
+    {
+        g_pacer.markDirty(FRAME_VIEW);
+        break;
+    }
     case WM_KEYDOWN:   // 키보드 입력 처리 (키가 눌릴때마다)
     {
         switch (wParam) {
@@ -1338,45 +915,18 @@ LRESULT CALLBACK d3d::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
                 wire = !wire;
                 Device->SetRenderState(D3DRS_FILLMODE,
                     (wire ? D3DFILL_WIREFRAME : D3DFILL_SOLID));
+                g_pacer.markDirty(FRAME_VIEW);
             }
             break;
         case VK_SPACE:   // 핵심 조작 로직 : 파란공과 흰공 위치 이용해 발사 방향 계산
 
             showGuideLine = false;   // 선 숨김
 
-            // white, yellow 바꾸기.
-
-            D3DXVECTOR3 targetpos = g_target_blueball.getCenter(); // 이건 if 문에 포함 x
-            if (isWhiteTurn == 1) {
-                D3DXVECTOR3	whitepos = g_sphere[3].getCenter();
-                double theta = acos(sqrt(pow(targetpos.x - whitepos.x, 2)) / sqrt(pow(targetpos.x - whitepos.x, 2) +
-                    pow(targetpos.z - whitepos.z, 2)));		// 기본 1 사분면
-                if (targetpos.z - whitepos.z <= 0 && targetpos.x - whitepos.x >= 0) { theta = -theta; }	//4 사분면
-                if (targetpos.z - whitepos.z >= 0 && targetpos.x - whitepos.x <= 0) { theta = PI - theta; } //2 사분면
-                if (targetpos.z - whitepos.z <= 0 && targetpos.x - whitepos.x <= 0) { theta = PI + theta; } // 3 사분면
-                double distance = sqrt(pow(targetpos.x - whitepos.x, 2) + pow(targetpos.z - whitepos.z, 2));
-                g_sphere[3].setPower(distance * cos(theta), distance * sin(theta));
-            }
-            else if (isWhiteTurn == -1) { // 노란공일 때
-                AIFireYellowBall(QTable);
-                /*D3DXVECTOR3	yellowpos = g_sphere[2].getCenter();
-                double theta = acos(sqrt(pow(targetpos.x - yellowpos.x, 2)) / sqrt(pow(targetpos.x - yellowpos.x, 2) +
-                    pow(targetpos.z - yellowpos.z, 2)));		// 기본 1 사분면
-                if (targetpos.z - yellowpos.z <= 0 && targetpos.x - yellowpos.x >= 0) { theta = -theta; }	//4 사분면
-                if (targetpos.z - yellowpos.z >= 0 && targetpos.x - yellowpos.x <= 0) { theta = PI - theta; } //2 사분면
-                if (targetpos.z - yellowpos.z <= 0 && targetpos.x - yellowpos.x <= 0) { theta = PI + theta; } // 3 사분면
-                double distance = sqrt(pow(targetpos.x - yellowpos.x, 2) + pow(targetpos.z - yellowpos.z, 2));
-                g_sphere[2].setPower(distance * cos(theta), distance * sin(theta));*/
-            }
-            else {
-                // 에러 처리
-            }
-
-            // 처음으로 눌렸을때 -> 게임 시작이니까 상태 변환
-            isTurnStarted = true;
-
-            // 턴 체인지의 시작점. -> 취소
-            // updateScore(); -> 취소
+            // 하얀공 턴이면 파란공 쪽으로, 노란공 턴이면 AI 가 조준해서 발사 (턴 시작)
+            GameInput fire = { INPUT_FIRE, 0, 0 };
+            g_simThread.post(fire);
+            g_pacer.markDirty(FRAME_AIM);
+            g_pacer.keepAwake(d3d::TimeMs(), INPUT_WAKE_MS);
 
 
         }
@@ -1442,13 +992,14 @@ LRESULT CALLBACK d3d::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
         // 마우스 왼쪽으로 회전하는 기능 제거
         if (LOWORD(wParam) & MK_RBUTTON) {
-            if (isWhiteTurn == 1){
+            if (g_simThread.latest().isWhiteTurn == 1){
               
-              // 파란공 이동만 허용
+              // 파란공 이동만 허용 (시뮬레이션 스레드에서 적용)
               float dx = (old_x - new_x);
               float dy = (old_y - new_y);
-              D3DXVECTOR3 coord3d = g_target_blueball.getCenter();
-              g_target_blueball.setCenter(coord3d.x + dx * (-0.007f), coord3d.y, coord3d.z + dy * 0.007f);
+              GameInput aim = { INPUT_AIM, dx * (-0.007f), dy * 0.007f };
+              g_simThread.post(aim);
+              g_pacer.keepAwake(d3d::TimeMs(), INPUT_WAKE_MS);
             }
             else; // player 2의 차례일 때에는 입력을 받지 않고 기다림.
         }
@@ -1480,12 +1031,79 @@ int WINAPI WinMain(HINSTANCE hinstance,
 
     // 디버깅용 콘솔 생성 종료
     */
-    LoadQTable(QTable);
+    SessionAI& ai = g_session.ai();
+    ai.saveEachTurn = true;   // 화면 게임은 턴마다 저장
 
-    srand(static_cast<unsigned int>(time(NULL)));
+    if (strstr(cmdLine, "-trace")) {
+        g_trace = true;
+        traceThreadName("display");
+        traceStart();
+    }
 
-    gs = g_sphere; // 배열 가리킴.
-    blue = &g_target_blueball; // 파란공 가리킴
+    // 학습 테이블 메모리 한도: "-qbudget <MB> [-qevict visit|lru|reward]"
+    float budgetMB = 0;
+    char evict[16];
+    const char* opt = strstr(cmdLine, "-qbudget ");
+    if (opt && sscanf(opt + 9, "%f", &budgetMB) == 1 && budgetMB > 0) {
+        ai.budget.maxBytes = (size_t)(budgetMB * (1 << 20));
+    }
+    opt = strstr(cmdLine, "-qevict ");
+    if (opt && sscanf(opt + 8, "%15s", evict) == 1) {
+        if (strcmp(evict, "lru") == 0) ai.budget.policy = QEVICT_LRU;
+        else if (strcmp(evict, "reward") == 0) ai.budget.policy = QEVICT_REWARD;
+    }
+
+    LoadQTable(ai.qTable);
+    EvictQTable(ai.qTable, ai.budget);   // 파일이 한도보다 크면 바로 줄임
+
+    // 배포용: "-nolearn" -> 정책표가 있으면 매 턴 표 조회 한 번으로 결정
+    if (strstr(cmdLine, "-nolearn")) {
+        ai.learning = false;
+        g_policy.open(POLICY_FILE);
+    }
+    ai.policy = &g_policy;
+
+    // 분산 학습: "-shard <path>". shard 는 이 trainer 가 처음부터 배운 것을 모두 담음 (누적).
+    // master 는 qTableTool merge 로 모든 shard 만 합쳐 매번 새로 만듦 (이전 master 는 넣지 않음).
+    char shardPath[260];
+    opt = strstr(cmdLine, "-shard ");
+    if (opt && sscanf(opt + 7, "%259s", shardPath) == 1) {
+        ai.shardPath = shardPath;
+        LoadQTable(ai.shardTable, shardPath);   // 이어서 학습
+        EvictQTable(ai.shardTable, ai.budget);
+        ai.replayPath = ai.shardPath + ".replay";   // 프로세스마다 따로
+    }
+
+    if (strstr(cmdLine, "-mlp")) g_mlp.load(MLP_FILE);
+    ai.mlp = &g_mlp;
+
+    // AI 조준, 턴마다 저장은 백그라운드에서 (코어가 하나여도 작업 스레드는 하나 둠)
+    int cores = (int)std::thread::hardware_concurrency();
+    g_pool = new CThreadPool(cores > 2 ? cores - 1 : 1);
+    ai.executor = g_pool;
+
+    // 탐색 AI: "-plan [ms]" / "-aim [ms]". ms 는 조준 한 번에 쓸 시간 (SessionAI::thinkBudgetMs).
+    // 없으면 플래너는 설정값 (200ms), CEM 은 회차 수 (AimConfig::iterations) 까지.
+    double ms;
+    opt = strstr(cmdLine, "-plan");
+    if (opt) {
+        if (sscanf(opt + 5, "%lf", &ms) == 1 && ms > 0) ai.thinkBudgetMs = ms;
+        g_planner = new CShotPlanner(*g_pool);
+        ai.planner = g_planner;
+    }
+    opt = strstr(cmdLine, "-aim");
+    if (opt) {
+        if (!ai.planner && sscanf(opt + 4, "%lf", &ms) == 1 && ms > 0) ai.thinkBudgetMs = ms;
+        g_aim = new CAimOptimizer(*g_pool);
+        ai.aim = g_aim;
+    }
+    // "-det": 결정적 (Fixed) 물리. 시뮬레이션 스레드가 고정 dt 로 돌므로 같은 샷이면 같은 결과.
+    if (strstr(cmdLine, "-det")) g_session.setDeterministic(true);
+    if (strstr(cmdLine, "-3c")) {
+        g_showThreeCushion = true;
+        g_threeCushion.attach(g_events);
+        g_session.setEventBus(&g_events);
+    }
 
     if (!d3d::InitD3D(hinstance,   // Direct3D 초기화
         Width, Height, true, D3DDEVTYPE_HAL, &Device))
@@ -1500,9 +1118,17 @@ int WINAPI WinMain(HINSTANCE hinstance,
         return 0;
     }
 
-    d3d::EnterMsgLoop(Display);   // Display() 반복 호출 (게임 루프)
+    g_simWake = ::CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (g_simWake) g_simThread.setWake(wakeDisplay, NULL);
+    g_simThread.start();
+    d3d::EnterMsgLoop(Display, &g_pacer, g_simWake);   // 바뀐 것이 있을 때만 Display() 호출 (게임 루프)
 
     Cleanup();   // 리소스 정리
+    if (g_simWake) ::CloseHandle(g_simWake);   // 시뮬레이션 스레드는 Cleanup 에서 멈춤
+    if (g_trace) {
+        traceStop();
+        traceWrite(TRACE_FILE);
+    }
 
     Device->Release();
 